@@ -5,12 +5,127 @@
     the Free Software Foundation, either version 3 of the License, or
     (at your option) any later version.
 */
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "numtraits.h"
+#include "registry.h"
+#include "microbench.h"
+#include "sweep.h"
+
 void algo_sqrt();
 void algo_log();
 void algo_trig();
 
-int main()
+void bench_log();
+void bench_ln_exponent();
+void bench_tan_iterations();
+void bench_sqrt_batch();
+void bench_ln_batch();
+void bench_exp_batch();
+void bench_trig_batch();
+void bench_types();
+void bench_cost(const CostModel &model);
+void sim_report(double khz);
+
+int main(int argc, char *argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+        bench_log();
+        bench_ln_exponent();
+        bench_tan_iterations();
+        bench_sqrt_batch();
+        bench_ln_batch();
+        bench_exp_batch();
+        bench_trig_batch();
+        bench_types();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "cost") == 0)
+    {
+        // Cycles per operation of the target, as "add=16 mul=256 ..."
+        CostModel model;
+        for (int i = 2; i < argc; i++)
+            if (!model.set(argv[i]))
+            {
+                std::cerr << "Unknown cost " << argv[i] << ", expected add, mul, div, shift, cmp or khz=value\n";
+                return 1;
+            }
+        bench_cost(model);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "micro") == 0)
+    {
+        // Latency and throughput of every implementation, as "latency trials=30 cpu=2 ..."
+        BenchOptions opt;
+        for (int i = 2; i < argc; i++)
+            if (!opt.set(argv[i]))
+            {
+                std::cerr << "Unknown option " << argv[i] << ", expected latency, throughput or trials, cpu, warmup, trial=value\n";
+                return 1;
+            }
+        microbench(opt);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "counters") == 0)
+    {
+        // Hardware counters per function and input class; takes the cpu, warmup and trial options of micro
+        BenchOptions opt;
+        for (int i = 2; i < argc; i++)
+            if (!opt.set(argv[i]))
+            {
+                std::cerr << "Unknown option " << argv[i] << ", expected cpu, warmup or trial=value\n";
+                return 1;
+            }
+        counter_bench(opt);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "dist") == 0)
+    {
+        // p50/p99/max latency per decimal exponent bucket; takes the cpu, warmup and samples options
+        BenchOptions opt;
+        for (int i = 2; i < argc; i++)
+            if (!opt.set(argv[i]))
+            {
+                std::cerr << "Unknown option " << argv[i] << ", expected cpu, warmup or samples=value\n";
+                return 1;
+            }
+        latency_distribution(opt);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0)
+    {
+        // Error in ulps over many inputs, as "fn=tan impl=simd range=float lo=-1 hi=1 threads=8 ..."
+        SweepOptions opt;
+        for (int i = 2; i < argc; i++)
+            if (!opt.set(argv[i]))
+            {
+                std::cerr << "Unknown option " << argv[i] << ", expected fn, impl, range=uniform|log|float or lo, hi, count, threads=value\n";
+                return 1;
+            }
+        return sweep(opt) ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "tune") == 0)
+    {
+        // Pick the fastest implementation of each function on this machine, for every later run
+        Registry &reg = Registry::get();
+        reg.tune(true);
+        if (!reg.save())
+        {
+            std::cerr << "Cannot write " << Registry::tune_file << "\n";
+            return 1;
+        }
+        std::cout << "Saved to " << Registry::tune_file << "\n";
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "sim") == 0)
+    {
+        // Clock of the simulated calculator in kHz, one digit time per cycle
+        sim_report(argc > 2 ? atof(argv[2]) : 200);
+        return 0;
+    }
+
     algo_sqrt();
     algo_trig();
     algo_log();
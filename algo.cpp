@@ -0,0 +1,124 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include "methods.h"
+#include "registry.h"
+
+// Printouts of the methods on a few inputs against the C library, through the implementations the registry selected
+
+constexpr double pi = 3.141592653589793;
+
+void algo_sqrt()
+{
+    const double tests_sqrt[] = {0,54757,125348,0.5,0.00035,0.02,1,1.234e78,1e-300};
+
+    const Registry &reg = Registry::get();
+
+    std::cout << "\n----- SQRT(x) -----\n";
+    for (int i = 0; i < sizeof(tests_sqrt) / sizeof(double); i++)
+    {
+        const double x = tests_sqrt[i];
+        const double verif = sqrt(x);
+        const double result = reg.one(Fn::sqrt, x);
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+}
+
+void algo_log()
+{
+    const Registry &reg = Registry::get();
+
+    const double tests_ln[] = {0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,1.234e34};
+    std::cout << "\n----- LN(x) -----\n";
+    for (int i = 0; i < sizeof(tests_ln) / sizeof(double); i++)
+    {
+        const double x = tests_ln[i];
+        const double verif = log(x);
+        const double result = reg.one(Fn::ln, x);
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+
+    const double tests_exp[] = {0,-1,0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,87.2332,1.234e-13,9.999e-15,230};
+    std::cout << "\n----- EXP(x) -----\n";
+    for (int i = 0; i < sizeof(tests_exp) / sizeof(double); i++)
+    {
+        const double x = tests_exp[i];
+        const double verif = exp(x);
+        const double result = reg.one(Fn::exp, x);
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+
+    std::cout << "\n----- LN(x)/EXP(x) SYMMETRY -----\n";
+    for (int i = 0; i < sizeof(tests_ln) / sizeof(double); i++)
+    {
+        const double x = tests_ln[i];
+        const double verif = exp(log(x));
+        const double result = reg.one(Fn::exp, reg.one(Fn::ln, x));
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+}
+
+#define SINCOS(x, s, c) sincos1(x, s, c)
+#define POLAR(x, y, r, theta) polar1(x, y, r, theta)
+
+void algo_trig()
+{
+    const Registry &reg = Registry::get();
+
+    const double tests_tan[] = {0,0.984736,0.1,0.5,1.5, pi/2, -1.5, 1.234e5, 1e22};
+    std::cout << "\n----- TAN(x) -----\n";
+    for (int i = 0; i < sizeof(tests_tan) / sizeof(double); i++)
+    {
+        const double x = tests_tan[i];
+        const double verif = tan(x);
+        const double result = reg.one(Fn::tan, x);
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+
+    const double tests_atan[] = {0, 1, 20, -20, -12345e23, pi, pi/2};
+    std::cout << "\n----- ATAN(x) -----\n";
+    for (int i = 0; i < sizeof(tests_atan) / sizeof(double); i++)
+    {
+        const double x = tests_atan[i];
+        const double verif = atan(x);
+        const double result = reg.one(Fn::atan, x);
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+
+    const double tests_sincos[] = {0, 0.5, 1, pi/2, 2, pi, -1, 4, 3*pi/2, 1.234e5, 1e22};
+    std::cout << "\n----- SINCOS(x) -----\n";
+    for (int i = 0; i < sizeof(tests_sincos) / sizeof(double); i++)
+    {
+        const double x = tests_sincos[i];
+        double s, c;
+        SINCOS(x, s, c);
+        std::cout << std::setprecision(15) << "x=" << x << " sin=" << s << " cos=" << c << "  error=" << sin(x) - s << ", " << cos(x) - c << "\n";
+    }
+
+    const double tests_polar[][2] = {{1, 0}, {1, 1}, {3, 4}, {-3, 4}, {-3, -4}, {3, -4}, {0, -2}, {-1, 0}, {1e-300, 2e-300}, {1e300, -1e300}, {12345.678, 0.001}};
+    std::cout << "\n----- POLAR(x,y) -----\n";
+    for (int i = 0; i < sizeof(tests_polar) / sizeof(tests_polar[0]); i++)
+    {
+        const double x = tests_polar[i][0];
+        const double y = tests_polar[i][1];
+        double r, theta;
+        POLAR(x, y, r, theta);
+        std::cout << std::setprecision(15) << "x=" << x << " y=" << y << " r=" << r << " theta=" << theta << "  error=" << hypot(x, y) - r << ", " << atan2(y, x) - theta << "\n";
+    }
+
+    std::cout << "\n----- TAN(x)/ATAN(x) SYMMETRY -----\n";
+    for (int i = 0; i < sizeof(tests_tan) / sizeof(double); i++)
+    {
+        const double x = tests_tan[i];
+        const double verif = atan(tan(x));
+        const double result = reg.one(Fn::atan, reg.one(Fn::tan, x));
+        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+    }
+}
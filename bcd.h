@@ -0,0 +1,443 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "numtraits.h"
+
+// Packed BCD: 16 decimal digits in a 64-bit word, one per nibble, the least significant digit in the low
+// nibble. The digits are added by the binary adder of the CPU, all 16 at once (SWAR)
+namespace bcd
+{
+constexpr unsigned long long sixes = 0x6666666666666666ULL;
+constexpr unsigned long long nines = 0x9999999999999999ULL;
+constexpr unsigned long long one = 0x1000000000000000ULL; // Leading digit 1, the mantissa of a power of ten
+
+/// <summary>
+/// Add two words of 16 digits and a carry, setting the carry out of the top digit
+/// Every digit of a is biased by 6 so that the binary adder carries out of a nibble exactly where the
+/// decimal adder carries out of a digit; the bias is then taken back from the digits that did not carry
+/// </summary>
+inline unsigned long long add(unsigned long long a, unsigned long long b, int &carry)
+{
+    const unsigned long long t1 = a + sixes;
+    const unsigned long long s1 = t1 + b;
+    const unsigned long long s2 = s1 + carry;
+    carry = s1 < t1 || s2 < s1;
+
+    const unsigned long long carries = s2 ^ t1 ^ b; // Bit i is set by the carry into bit i
+    const unsigned long long no_carry = ~carries & 0x1111111111111110ULL;
+    unsigned long long bias = (no_carry >> 2) | (no_carry >> 3);
+    if (!carry)
+        bias |= 0x6ULL << 60;
+    return s2 - bias;
+}
+
+/// <summary>
+/// Subtract two words of 16 digits and a borrow, as the addition of the nines' complement of b
+/// </summary>
+inline unsigned long long sub(unsigned long long a, unsigned long long b, int &borrow)
+{
+    int carry = 1 - borrow;
+    const unsigned long long r = add(a, nines - b, carry);
+    borrow = 1 - carry;
+    return r;
+}
+
+/// <summary>
+/// Number of significant digits of a word
+/// </summary>
+inline int digits(unsigned long long w)
+{
+    if (w == 0)
+        return 0;
+#if defined(__GNUC__)
+    return 16 - __builtin_clzll(w) / 4;
+#else
+    int n = 16;
+    while (!(w >> 60))
+    {
+        w <<= 4;
+        n--;
+    }
+    return n;
+#endif
+}
+
+/// <summary>
+/// 32-digit register, the double width data path of the multiplier and divider, with room for the
+/// guard digits of the adder
+/// </summary>
+struct Reg
+{
+    unsigned long long hi = 0, lo = 0;
+
+    friend Reg operator+(Reg a, Reg b)
+    {
+        int c = 0;
+        a.lo = add(a.lo, b.lo, c);
+        a.hi = add(a.hi, b.hi, c);
+        return a;
+    }
+    friend Reg operator-(Reg a, Reg b) // a >= b
+    {
+        int c = 0;
+        a.lo = sub(a.lo, b.lo, c);
+        a.hi = sub(a.hi, b.hi, c);
+        return a;
+    }
+    friend bool operator<(Reg a, Reg b) { return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo; }
+    bool zero() const { return (hi | lo) == 0; }
+    int digits() const { return hi ? 16 + bcd::digits(hi) : bcd::digits(lo); }
+    int digit(int i) const { return int(((i < 16 ? lo : hi) >> (4 * (i % 16))) & 0xF); }
+
+    /// <summary>
+    /// Shift left by k digits, 0 <= k < 32
+    /// </summary>
+    Reg shl(int k) const
+    {
+        Reg r;
+        if (k == 0)
+            return *this;
+        if (k >= 16)
+        {
+            r.hi = lo << (4 * (k - 16));
+            return r;
+        }
+        r.hi = (hi << (4 * k)) | (lo >> (64 - 4 * k));
+        r.lo = lo << (4 * k);
+        return r;
+    }
+
+    /// <summary>
+    /// Shift right by k digits, 0 <= k < 32; sticky is set when a nonzero digit is shifted out
+    /// </summary>
+    Reg shr(int k, bool &sticky) const
+    {
+        Reg r;
+        if (k == 0)
+            return *this;
+        if (k >= 16)
+        {
+            sticky = sticky || lo || (k > 16 && (hi << (64 - 4 * (k - 16))));
+            r.lo = k == 16 ? hi : hi >> (4 * (k - 16));
+            return r;
+        }
+        sticky = sticky || (lo << (64 - 4 * k));
+        r.lo = (lo >> (4 * k)) | (hi << (64 - 4 * k));
+        r.hi = hi >> (4 * k);
+        return r;
+    }
+};
+} // namespace bcd
+
+/// <summary>
+/// Packed BCD floating point number: 16 digits in a 64-bit word, a decimal exponent and a sign,
+/// the number format of a calculator register
+/// value = (-1)^neg x mant x 10^exp, where mant is read as a 16-digit integer whose leading digit is
+/// nonzero unless the value is zero
+/// All arithmetic is done on the BCD digits: the adder aligns the operands by a digit shift and adds
+/// them in a register with guard digits, the multiplier adds shifted multiples of the multiplicand and the
+/// divider subtracts the divisor digit by digit. Every operation is rounded once to nearest, ties to even;
+/// exp is an int, so there is no overflow, and there are no NaN or infinities
+/// </summary>
+class Bcd
+{
+public:
+    static constexpr int digits = 16;
+    unsigned long long mant = 0;
+    int exp = 0;
+    bool neg = false;
+
+    Bcd() = default;
+    Bcd(int v)
+    {
+        unsigned long long u = v < 0 ? -(long long)v : v;
+        bcd::Reg r;
+        for (int i = 0; u; i++, u /= 10)
+            r.lo |= (u % 10) << (4 * i);
+        *this = round(v < 0, r, 0, false);
+    }
+    Bcd(double v) : Bcd((long double)v) {}
+    Bcd(long double v)
+    {
+        if (v == 0 || !std::isfinite(v))
+            return;
+        // The C library does the correctly rounded binary to decimal conversion
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%.15Le", std::fabs(v));
+        for (const char *p = buf; *p != 'e'; p++)
+            if (*p != '.')
+                mant = (mant << 4) | (unsigned long long)(*p - '0');
+        exp = std::atoi(std::strchr(buf, 'e') + 1) - (digits - 1);
+        neg = v < 0;
+    }
+    explicit operator long double() const
+    {
+        char buf[40];
+        format(buf, sizeof(buf));
+        return std::strtold(buf, nullptr);
+    }
+    explicit operator double() const
+    {
+        char buf[40];
+        format(buf, sizeof(buf));
+        return std::strtod(buf, nullptr);
+    }
+
+    /// <summary>
+    /// Write the value as "[-]ddddddddddddddddE<exp>"
+    /// </summary>
+    void format(char *buf, size_t size) const
+    {
+        char d[digits + 1];
+        for (int i = 0; i < digits; i++)
+            d[i] = char('0' + ((mant >> (4 * (digits - 1 - i))) & 0xF));
+        d[digits] = 0;
+        std::snprintf(buf, size, "%s%sE%d", neg ? "-" : "", d, exp);
+    }
+
+    /// <summary>
+    /// Round the exact result r x 10^e to 16 digits; sticky tells that nonzero digits were dropped below r
+    /// </summary>
+    static Bcd round(bool neg, bcd::Reg r, int e, bool sticky)
+    {
+        Bcd b;
+        const int nd = r.digits();
+        if (nd == 0)
+            return b;
+
+        if (nd > digits)
+        {
+            const int drop = nd - digits;
+            const int rd = r.digit(drop - 1);
+            bool below = sticky, dropped = false;
+            r = r.shr(drop - 1, below);
+            r = r.shr(1, dropped);
+            e += drop;
+            if (rd > 5 || (rd == 5 && (below || (r.lo & 1))))
+            {
+                int c = 0;
+                r.lo = bcd::add(r.lo, 1, c);
+                if (c)
+                {
+                    r.lo = bcd::one;
+                    e++;
+                }
+            }
+        }
+        else if (nd < digits)
+        {
+            r = r.shl(digits - nd);
+            e -= digits - nd;
+        }
+
+        b.mant = r.lo;
+        b.exp = e;
+        b.neg = neg;
+        return b;
+    }
+
+    friend Bcd operator+(Bcd a, Bcd b)
+    {
+        if (b.mant == 0)
+            return a;
+        if (a.mant == 0)
+            return b;
+        if (a.exp < b.exp)
+        {
+            const Bcd t = a;
+            a = b;
+            b = t;
+        }
+        // b is below 1/100 of a unit in the last place of a, it cannot move the rounded result
+        const int d = a.exp - b.exp;
+        if (d > digits + 1)
+            return a;
+
+        // a goes to the top of the register, one digit below the carry; b is aligned to it by a digit shift
+        bcd::Reg ra, rb;
+        ra.lo = a.mant;
+        ra = ra.shl(digits - 1);
+        rb.lo = b.mant;
+        bool sticky = false;
+        rb = d < digits ? rb.shl(digits - 1 - d) : rb.shr(d - (digits - 1), sticky);
+        const int e = a.exp - (digits - 1);
+
+        if (a.neg == b.neg)
+            return round(a.neg, ra + rb, e, sticky);
+
+        // Digits shifted out of b make it larger than the register: subtract one more and keep the rest sticky
+        if (sticky)
+        {
+            bcd::Reg unit;
+            unit.lo = 1;
+            rb = rb + unit;
+        }
+        if (rb < ra)
+            return round(a.neg, ra - rb, e, sticky);
+        return round(b.neg, rb - ra, e, sticky);
+    }
+
+    friend Bcd operator-(Bcd a)
+    {
+        a.neg = !a.neg;
+        return a;
+    }
+
+    friend Bcd operator-(Bcd a, Bcd b) { return a + -b; }
+
+    friend Bcd operator*(Bcd a, Bcd b)
+    {
+        const bool neg = a.neg != b.neg;
+        if (a.mant == 0 || b.mant == 0)
+            return Bcd();
+        // A power of ten only moves the exponent
+        if (b.mant == bcd::one)
+            return scaled(a, neg, b.exp + digits - 1);
+        if (a.mant == bcd::one)
+            return scaled(b, neg, a.exp + digits - 1);
+
+        // Multiples 0..9 of a, then one shifted add per digit of b
+        bcd::Reg m[10];
+        m[1].lo = a.mant;
+        for (int k = 2; k < 10; k++)
+            m[k] = m[k - 1] + m[1];
+
+        bcd::Reg p;
+        for (int i = 0; i < digits; i++)
+        {
+            const int d = int((b.mant >> (4 * i)) & 0xF);
+            if (d)
+                p = p + m[d].shl(i);
+        }
+        return round(neg, p, a.exp + b.exp, false);
+    }
+
+    friend Bcd operator/(Bcd a, Bcd b)
+    {
+        if (b.mant == 0)
+            return Bcd(); // Error: Division by zero
+        const bool neg = a.neg != b.neg;
+        if (a.mant == 0)
+            return Bcd();
+        if (b.mant == bcd::one)
+            return scaled(a, neg, -b.exp - (digits - 1));
+
+        // Restoring division, one quotient digit at a time: 17 digits or more, the remainder is sticky
+        bcd::Reg rem, div, q;
+        rem.lo = a.mant;
+        div.lo = b.mant;
+        for (int i = 0; i < digits + 2; i++)
+        {
+            unsigned long long d = 0;
+            while (!(rem < div))
+            {
+                rem = rem - div;
+                d++;
+            }
+            q = q.shl(1);
+            q.lo |= d;
+            rem = rem.shl(1);
+        }
+        return round(neg, q, a.exp - b.exp - (digits + 1), !rem.zero());
+    }
+
+    static int compare(const Bcd &a, const Bcd &b)
+    {
+        const int sa = a.mant == 0 ? 0 : a.neg ? -1 : 1;
+        const int sb = b.mant == 0 ? 0 : b.neg ? -1 : 1;
+        if (sa != sb)
+            return sa < sb ? -1 : 1;
+        if (sa == 0)
+            return 0;
+        // Mantissas are normalized, so the exponent orders the magnitudes first; BCD words order as integers
+        int m = 0;
+        if (a.exp != b.exp)
+            m = a.exp < b.exp ? -1 : 1;
+        else if (a.mant != b.mant)
+            m = a.mant < b.mant ? -1 : 1;
+        return sa * m;
+    }
+
+    friend bool operator==(const Bcd &a, const Bcd &b) { return compare(a, b) == 0; }
+    friend bool operator!=(const Bcd &a, const Bcd &b) { return compare(a, b) != 0; }
+    friend bool operator<(const Bcd &a, const Bcd &b) { return compare(a, b) < 0; }
+    friend bool operator<=(const Bcd &a, const Bcd &b) { return compare(a, b) <= 0; }
+    friend bool operator>(const Bcd &a, const Bcd &b) { return compare(a, b) > 0; }
+    friend bool operator>=(const Bcd &a, const Bcd &b) { return compare(a, b) >= 0; }
+
+private:
+    static Bcd scaled(Bcd a, bool neg, int e)
+    {
+        a.exp += e;
+        a.neg = neg;
+        return a;
+    }
+};
+
+/// <summary>
+/// a x (1 + 10^-k) is the fused add/shift of the BCD data path: "a = a + (a >> k)"
+/// </summary>
+inline Bcd mul_1p10(const Bcd &a, const Bcd &, int k)
+{
+    Bcd s = a;
+    s.exp -= k;
+    return a + s;
+}
+
+/// <summary>
+/// The exponent of a BCD value is decimal: split() and scale() are exact and only touch exp
+/// </summary>
+template <>
+struct num_traits<Bcd>
+{
+    using wide = long double;
+    static constexpr int radix = 10;
+    static constexpr int depth = 9;
+    static constexpr int newton = 6;
+
+    static Bcd epsilon()
+    {
+        Bcd e;
+        e.mant = bcd::one;
+        e.exp = -30; // 10^15 x 10^-30
+        return e;
+    }
+    static Bcd abs(Bcd x)
+    {
+        x.neg = false;
+        return x;
+    }
+    static bool isfinite(const Bcd &) { return true; }
+    static bool isnan(const Bcd &) { return false; }
+    static bool signbit(const Bcd &x) { return x.neg; }
+    static Bcd split(Bcd x, int &e)
+    {
+        e = x.mant ? x.exp + Bcd::digits : 0;
+        if (x.mant)
+            x.exp = -Bcd::digits;
+        return x;
+    }
+    static Bcd scale(Bcd x, int e)
+    {
+        if (x.mant)
+            x.exp += e;
+        return x;
+    }
+    static double to_double(const Bcd &x)
+    {
+        double m = 0;
+        for (int i = Bcd::digits - 1; i >= 0; i--)
+            m = m * 10 + double((x.mant >> (4 * i)) & 0xF);
+        return (x.neg ? -m : m) * std::pow(10.0, x.exp);
+    }
+};
@@ -0,0 +1,327 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <string>
+#include "methods.h"
+#include "simd.h"
+
+/// <summary>
+/// Return the average time of a single call of f(), in nanoseconds, over all inputs
+/// </summary>
+template <typename F>
+static double ns_per_call(F f, const double *in, int count, int reps)
+{
+    double acc = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        for (int i = 0; i < count; i++)
+            acc += f(in[i]);
+    const auto stop = std::chrono::steady_clock::now();
+
+    volatile double sink = acc; // Keep the calls from being optimized away
+    (void)sink;
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(reps) * count);
+}
+
+void bench_log()
+{
+    const double tests_ln[] = {0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,1.234e34};
+    const double tests_exp[] = {0,-1,0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,87.2332,1.234e-13,9.999e-15,230};
+    const int n_ln = sizeof(tests_ln) / sizeof(double);
+    const int n_exp = sizeof(tests_exp) / sizeof(double);
+    const int reps = 100000;
+
+    std::cout << "\n----- LN(x)/EXP(x) ns per call -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "ln1  " << ns_per_call(ln1<double>, tests_ln, n_ln, reps) << "  log  " << ns_per_call([](double x) { return log(x); }, tests_ln, n_ln, reps) << "\n";
+    std::cout << "exp1 " << ns_per_call(exp1<double>, tests_exp, n_exp, reps) << "  exp  " << ns_per_call([](double x) { return exp(x); }, tests_exp, n_exp, reps) << "\n";
+}
+
+void bench_ln_exponent()
+{
+    std::cout << "\n----- LN(x) ns per call by decimal exponent -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (int e = -300; e <= 300; e += 50)
+    {
+        const double x[] = {1.234 * pow(10, e), 5.678 * pow(10, e), 9.87 * pow(10, e)};
+        std::cout << "1e" << std::setw(4) << std::left << e << std::right << "  ln1 " << std::setw(8) << ns_per_call(ln1<double>, x, 3, 100000) << "\n";
+    }
+}
+
+void bench_tan_iterations()
+{
+    // Uniform sweep of angles over a full turn
+    const double pi = 3.141592653589793;
+    const int steps = 100000;
+    long total = 0, worst = 0;
+    for (int i = 0; i < steps; i++)
+    {
+        const long count = tan1_steps(2 * pi * i / steps);
+        total += count;
+        worst = count > worst ? count : worst;
+    }
+
+    std::cout << "\n----- TAN(x) digit loop iterations over [0, 2*pi) -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "average " << double(total) / steps << "  worst " << worst << "\n";
+}
+
+/// <summary>
+/// Return the time to process one element, in nanoseconds, of an array function over the inputs
+/// </summary>
+template <typename F>
+static double ns_per_element(F f, const std::vector<double> &in, int reps)
+{
+    std::vector<double> out(in.size());
+    double acc = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+    {
+        f(in.data(), out.data(), in.size());
+        acc += out[r % out.size()];
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    volatile double sink = acc;
+    (void)sink;
+
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(reps) * in.size());
+}
+
+/// <summary>
+/// Print the throughput of an array function, in ns and millions of elements per second
+/// </summary>
+template <typename F>
+static void print_throughput(const char *name, F f, const std::vector<double> &in, int reps)
+{
+    const double ns = ns_per_element(f, in, reps);
+    std::cout << std::left << std::setw(20) << name << std::right << std::setw(8) << ns << " ns  " << std::setw(8) << 1e3 / ns << " M/s\n";
+}
+
+/// <summary>
+/// Print the throughput of a batch function with the kernel of each level the CPU supports, forced one at a time
+/// </summary>
+static void print_throughput_levels(const char *name, BatchKernel f, const std::vector<double> &in, int reps)
+{
+    const Isa level = Dispatch::level();
+    for (int i = 0; i <= int(cpu_isa()); i++)
+    {
+        Dispatch::force(Isa(i));
+        print_throughput((std::string(name) + " " + isa_name(Isa(i))).c_str(), f, in, reps);
+    }
+    Dispatch::force(level);
+}
+
+/// <summary>
+/// Return count values spread log-uniformly over [10^lo, 10^hi)
+/// </summary>
+static std::vector<double> log_uniform(size_t count, double lo, double hi)
+{
+    std::mt19937_64 gen(1);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> v(count);
+    for (auto &x : v)
+        x = pow(10, dist(gen));
+    return v;
+}
+
+void bench_sqrt_batch()
+{
+    const auto in = log_uniform(4096, -300, 300);
+    const int reps = 200;
+
+    std::cout << "\n----- SQRT(x) throughput per element -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    print_throughput("sqrt1", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = sqrt1(in[i]); }, in, reps);
+    print_throughput_levels("sqrt1_batch", sqrt1_batch, in, reps);
+    print_throughput("std::sqrt", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::sqrt(in[i]); }, in, reps);
+}
+
+void bench_ln_batch()
+{
+    const auto in = log_uniform(4096, -300, 300);
+    const int reps = 100;
+
+    std::cout << "\n----- LN(x) throughput per element -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    print_throughput("ln1", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = ln1(in[i]); }, in, reps);
+    print_throughput_levels("ln1_batch", ln1_batch, in, reps);
+    print_throughput("std::log", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::log(in[i]); }, in, reps);
+}
+
+void bench_exp_batch()
+{
+    std::mt19937_64 gen(1);
+    std::uniform_real_distribution<double> dist(-230, 230);
+    std::vector<double> in(4096);
+    for (auto &x : in)
+        x = dist(gen);
+    const int reps = 50;
+
+    std::cout << "\n----- EXP(x) throughput per element -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    print_throughput("exp1", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = exp1(in[i]); }, in, reps);
+    print_throughput_levels("exp1_batch", exp1_batch, in, reps);
+    print_throughput("std::exp", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::exp(in[i]); }, in, reps);
+}
+
+void bench_trig_batch()
+{
+    std::mt19937_64 gen(1);
+    std::uniform_real_distribution<double> dist(-10, 10);
+    std::vector<double> in(4096);
+    for (auto &x : in)
+        x = dist(gen);
+    const int reps = 100;
+
+    std::cout << "\n----- TAN(x)/ATAN(x) throughput per element -----\n";
+    std::cout << std::fixed << std::setprecision(2);
+    print_throughput("tan1", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = tan1(in[i]); }, in, reps);
+    print_throughput_levels("tan1_batch", tan1_batch, in, reps);
+    print_throughput("std::tan", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::tan(in[i]); }, in, reps);
+    print_throughput("atan1", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = atan1(in[i]); }, in, reps);
+    print_throughput_levels("atan1_batch", atan1_batch, in, reps);
+    print_throughput("std::atan", [](const double *in, double *out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::atan(in[i]); }, in, reps);
+}
+
+/// <summary>
+/// Print the largest relative error of f against the long double reference, and its time per call, over T
+/// </summary>
+template <typename T, typename F, typename R>
+static void print_type_column(F f, R ref, const std::vector<double> &in, int reps)
+{
+    std::vector<T> x(in.size());
+    for (size_t i = 0; i < in.size(); i++)
+        x[i] = T(in[i]);
+
+    long double worst = 0;
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        const long double verif = ref((long double)in[i]);
+        worst = std::max(worst, std::fabs((long double)f(x[i]) - verif) / std::fabs(verif));
+    }
+
+    T acc = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        for (size_t i = 0; i < x.size(); i++)
+            acc = acc + f(x[i]);
+    const auto stop = std::chrono::steady_clock::now();
+
+    volatile double sink = num_traits<T>::to_double(acc); // Keep the calls from being optimized away
+    (void)sink;
+
+    std::cout << std::scientific << std::setprecision(1) << std::setw(10) << double(worst)
+              << std::fixed << std::setw(9) << std::chrono::duration<double, std::nano>(stop - start).count() / (double(reps) * x.size());
+}
+
+template <typename T>
+static void print_type_row(const char *name)
+{
+    const int count = 1000;
+    const int reps = 5;
+    std::mt19937_64 gen(1);
+    auto uniform = [&gen](double lo, double hi) {
+        std::uniform_real_distribution<double> dist(lo, hi);
+        std::vector<double> v(count);
+        for (auto &x : v)
+            x = dist(gen);
+        return v;
+    };
+
+    std::cout << std::setw(12) << std::left << name << std::right;
+    print_type_column<T>(sqrt1<T>, [](long double x) { return std::sqrt(x); }, log_uniform(count, -2, 3), reps);
+    print_type_column<T>(ln1<T>, [](long double x) { return std::log(x); }, log_uniform(count, -2, 3), reps);
+    print_type_column<T>(exp1<T>, [](long double x) { return std::exp(x); }, uniform(-10, 10), reps);
+    print_type_column<T>(tan1<T>, [](long double x) { return std::tan(x); }, uniform(-1.5, 1.5), reps);
+    print_type_column<T>(atan1<T>, [](long double x) { return std::atan(x); }, uniform(-100, 100), reps);
+    std::cout << "\n";
+}
+
+/// <summary>
+/// The same methods over each number type: worst relative error and ns per call, to pick the cheapest
+/// type that meets the accuracy a job needs. The inputs stay within the range of the fixed point type
+/// and the long double reference does not resolve errors much below 1e-19
+/// </summary>
+void bench_types()
+{
+    std::cout << "\n----- Number types: max relative error, ns per call -----\n";
+    std::cout << "type                sqrt1                ln1               exp1               tan1              atan1\n";
+    print_type_row<float>("float");
+    print_type_row<double>("double");
+    print_type_row<long double>("long double");
+#ifdef __SIZEOF_FLOAT128__
+    print_type_row<__float128>("__float128");
+#endif
+    print_type_row<Fixed>("Fixed");
+#ifdef __SIZEOF_INT128__
+    print_type_row<Decimal>("Decimal");
+    print_type_row<Dec64>("Dec64");
+    print_type_row<Dec128>("Dec128");
+#endif
+    print_type_row<Bcd>("Bcd");
+}
+
+/// <summary>
+/// Print the operations f does per call, on average over the inputs, and the latency they add up to
+/// </summary>
+template <typename F>
+static void print_cost_row(const char *name, F f, const std::vector<double> &in, const CostModel &model)
+{
+    OpCounts total;
+    double worst = 0;
+    for (double x : in)
+    {
+        const OpCounts start = op_counts;
+        f(Counted(x));
+        const OpCounts count = op_counts - start;
+        total += count;
+        worst = std::max(worst, model.cycles(count));
+    }
+
+    const double n = double(in.size());
+    std::cout << std::setw(8) << std::left << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << total.add / n << std::setw(8) << total.mul / n << std::setw(8) << total.div / n
+              << std::setw(8) << total.shift / n << std::setw(8) << total.cmp / n
+              << std::setprecision(0) << std::setw(12) << model.cycles(total) / n << std::setw(12) << worst
+              << std::setprecision(1) << std::setw(10) << 1e3 * model.cycles(total) / n / model.khz << "\n";
+}
+
+/// <summary>
+/// Operation counts of each method, from the instrumented number type, and the latency on a target
+/// whose cycles per operation are given by the cost model. Inputs are those of bench_types()
+/// </summary>
+void bench_cost(const CostModel &model)
+{
+    const int count = 1000;
+    std::mt19937_64 gen(1);
+    auto uniform = [&gen](double lo, double hi) {
+        std::uniform_real_distribution<double> dist(lo, hi);
+        std::vector<double> v(count);
+        for (auto &x : v)
+            x = dist(gen);
+        return v;
+    };
+
+    std::cout << "\n----- Operations per call and estimated latency -----\n";
+    std::cout << "cycles: add " << model.add << "  mul " << model.mul << "  div " << model.div << "  shift " << model.shift
+              << "  cmp " << model.cmp << "  at " << model.khz << " kHz\n";
+    std::cout << "method      add     mul     div   shift     cmp  cycles avg  cycles max    avg us\n";
+    print_cost_row("sqrt1", sqrt1<Counted>, log_uniform(count, -2, 3), model);
+    print_cost_row("ln1", ln1<Counted>, log_uniform(count, -2, 3), model);
+    print_cost_row("exp1", exp1<Counted>, uniform(-10, 10), model);
+    print_cost_row("tan1", tan1<Counted>, uniform(-1.5, 1.5), model);
+    print_cost_row("atan1", atan1<Counted>, uniform(-100, 100), model);
+}
@@ -0,0 +1,680 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <utility>
+#include "numtraits.h"
+
+#ifdef __SIZEOF_INT128__
+
+// IEEE 754-2008 decimal64 and decimal128 in the binary integer decimal (BID) encoding
+// A value is (-1)^sign x coefficient x 10^exponent with a binary integer coefficient of up to 16 or 34
+// digits; it is not normalized, so a value has several representations (a cohort) and exact results keep
+// the exponent the standard prefers. Rounding is to nearest, ties to even
+namespace bid
+{
+using u128 = unsigned __int128;
+
+/// <summary>
+/// Powers of ten 10^0 .. 10^38, all of them that fit 128 bits
+/// </summary>
+struct Pow10
+{
+    u128 v[39];
+    constexpr Pow10() : v()
+    {
+        v[0] = 1;
+        for (int i = 1; i < 39; i++)
+            v[i] = v[i - 1] * 10;
+    }
+    constexpr u128 operator[](int i) const { return v[i]; }
+};
+inline constexpr Pow10 pow10{};
+
+/// <summary>
+/// Number of decimal digits of c, from its bit length: 2^(L-1) <= c < 2^L gives floor(L x log10(2)) or one more
+/// </summary>
+inline int digits(unsigned long long c)
+{
+    if (c == 0)
+        return 0;
+    const int d = ((64 - __builtin_clzll(c)) * 1233) >> 12;
+    return d + (c >= (unsigned long long)pow10[d]);
+}
+
+inline int digits(u128 c)
+{
+    const unsigned long long hi = (unsigned long long)(c >> 64);
+    if (hi == 0)
+        return digits((unsigned long long)c);
+    const int d = ((128 - __builtin_clzll(hi)) * 1233) >> 12;
+    return d + (c >= pow10[d]);
+}
+
+template <int K>
+unsigned long long quotient10(unsigned long long c)
+{
+    return c / (unsigned long long)pow10[K];
+}
+
+template <int... K>
+constexpr auto quotients10(std::integer_sequence<int, K...>)
+{
+    return std::array<unsigned long long (*)(unsigned long long), sizeof...(K)>{quotient10<K>...};
+}
+
+/// <summary>
+/// Quotient by 10^k, 0 <= k <= 19, of a 64-bit value; each divisor is a constant in its own function,
+/// which the compiler turns into a multiplication, so the common case never runs a divide instruction
+/// </summary>
+inline constexpr auto quotient10_table = quotients10(std::make_integer_sequence<int, 20>());
+
+/// <summary>
+/// Divide by 10^k, k <= 19 for a 64-bit value and k <= 38 for a 128-bit one
+/// </summary>
+inline unsigned long long div10(unsigned long long c, int k, unsigned long long &rem)
+{
+    const unsigned long long q = quotient10_table[k](c);
+    rem = c - q * (unsigned long long)pow10[k];
+    return q;
+}
+
+inline u128 div10(u128 c, int k, u128 &rem)
+{
+    if ((c >> 64) == 0 && k < 20)
+    {
+        unsigned long long r;
+        const unsigned long long q = div10((unsigned long long)c, k, r);
+        rem = r;
+        return q;
+    }
+    rem = c % pow10[k];
+    return c / pow10[k];
+}
+
+enum Class { finite, infinite, quiet_nan };
+
+/// <summary>
+/// Decoded value: the arithmetic works on this and encodes the result back
+/// The coefficient is C, the smallest integer that holds the sum of two aligned operands
+/// </summary>
+template <typename C>
+struct Unpacked
+{
+    C c = 0;
+    int e = 0;
+    bool neg = false;
+    Class cls = finite;
+};
+
+/// <summary>
+/// decimal64: 16 digits, exponent in [-398, 369]
+/// The coefficient is in the low 53 bits, or in the low 51 bits after an implicit 100 when it needs 54
+/// </summary>
+struct Format64
+{
+    using bits_t = unsigned long long;
+    using unpacked = Unpacked<unsigned long long>;
+    static constexpr int digits = 16;
+    static constexpr int bias = 398;
+    static constexpr int emax = 369;
+
+    static unpacked decode(bits_t b)
+    {
+        unpacked u;
+        u.neg = b >> 63;
+        if (((b >> 61) & 3) == 3)
+        {
+            if (((b >> 59) & 3) == 3)
+            {
+                u.cls = (b >> 58) & 1 ? quiet_nan : infinite;
+                return u;
+            }
+            u.e = int((b >> 51) & 0x3FF) - bias;
+            u.c = (1ULL << 53) | (b & ((1ULL << 51) - 1));
+            if (u.c >= pow10[digits]) // Non-canonical coefficient reads as zero
+                u.c = 0;
+        }
+        else
+        {
+            u.e = int((b >> 53) & 0x3FF) - bias;
+            u.c = b & ((1ULL << 53) - 1);
+        }
+        return u;
+    }
+    static bits_t encode(const unpacked &u)
+    {
+        const bits_t sign = (bits_t)u.neg << 63;
+        if (u.cls == quiet_nan)
+            return sign | 0x7C00000000000000ULL;
+        if (u.cls == infinite)
+            return sign | 0x7800000000000000ULL;
+        const bits_t c = (bits_t)u.c, e = (bits_t)(u.e + bias);
+        if (c >> 53)
+            return sign | (3ULL << 61) | (e << 51) | (c & ((1ULL << 51) - 1));
+        return sign | (e << 53) | c;
+    }
+};
+
+/// <summary>
+/// decimal128: 34 digits, exponent in [-6176, 6111]
+/// A canonical coefficient is below 10^34 < 2^113, so it always sits in the low 113 bits
+/// </summary>
+struct Format128
+{
+    using bits_t = u128;
+    using unpacked = Unpacked<u128>;
+    static constexpr int digits = 34;
+    static constexpr int bias = 6176;
+    static constexpr int emax = 6111;
+
+    static unpacked decode(bits_t b)
+    {
+        unpacked u;
+        u.neg = (unsigned)(b >> 127);
+        const unsigned top = (unsigned)(b >> 122) & 0x1F;
+        if ((top >> 3) == 3)
+        {
+            if ((top >> 1) == 0xF)
+                u.cls = top & 1 ? quiet_nan : infinite;
+            return u; // Otherwise non-canonical, reads as zero
+        }
+        u.e = int((b >> 113) & 0x3FFF) - bias;
+        u.c = b & (((u128)1 << 113) - 1);
+        if (u.c >= pow10[digits])
+            u.c = 0;
+        return u;
+    }
+    static bits_t encode(const unpacked &u)
+    {
+        const bits_t sign = (bits_t)u.neg << 127;
+        if (u.cls == quiet_nan)
+            return sign | ((bits_t)0x1F << 122);
+        if (u.cls == infinite)
+            return sign | ((bits_t)0x1E << 122);
+        return sign | ((bits_t)(u.e + bias) << 113) | u.c;
+    }
+};
+
+/// <summary>
+/// Round the exact result c x 10^e, c of up to 38 digits, to the precision and exponent range of F
+/// sticky tells that nonzero digits were already dropped below c
+/// </summary>
+template <typename F, typename C>
+typename F::unpacked finish(bool neg, C c, int e, bool sticky)
+{
+    typename F::unpacked u;
+    u.neg = neg;
+
+    int drop = digits(c) - F::digits;
+    if (drop < -F::bias - e) // Below the smallest exponent the value goes subnormal
+        drop = -F::bias - e;
+    if (drop > 0)
+    {
+        if (drop > (sizeof(C) == 8 ? 19 : 38))
+            c = 0; // More digits than c has, below half of the smallest subnormal
+        else
+        {
+            // One division: the remainder against half of 10^drop decides, with the sticky bit breaking a tie
+            C rem;
+            c = div10(c, drop, rem);
+            const C half = 5 * (C)pow10[drop - 1];
+            if (rem > half || (rem == half && (sticky || (c & 1))))
+                c++;
+            if (c == (C)pow10[F::digits])
+            {
+                c = (C)pow10[F::digits - 1];
+                e++;
+            }
+        }
+        e += drop;
+    }
+
+    if (c == 0)
+    {
+        e = e < -F::bias ? -F::bias : e > F::emax ? F::emax : e;
+    }
+    else if (e > F::emax)
+    {
+        // Pad the coefficient with zeros if it has room, otherwise overflow to infinity
+        const int pad = e - F::emax;
+        if (digits(c) + pad > F::digits)
+        {
+            u.cls = infinite;
+            return u;
+        }
+        c = c * (C)pow10[pad];
+        e = F::emax;
+    }
+    u.c = (decltype(u.c))c;
+    u.e = e;
+    return u;
+}
+
+template <typename F>
+typename F::unpacked make_nan()
+{
+    typename F::unpacked u;
+    u.cls = quiet_nan;
+    return u;
+}
+
+/// <summary>
+/// a + b; exact when the exponents are equal or the operands are close, otherwise the smaller operand is
+/// aligned to the larger one, which keeps two guard digits, with its dropped digits folded into a sticky bit
+/// </summary>
+template <typename F>
+typename F::unpacked add(typename F::unpacked a, typename F::unpacked b)
+{
+    using C = decltype(a.c);
+    if (a.cls || b.cls)
+    {
+        if (a.cls == quiet_nan || b.cls == quiet_nan || (a.cls == infinite && b.cls == infinite && a.neg != b.neg))
+            return make_nan<F>();
+        return a.cls == infinite ? a : b;
+    }
+    if (b.c == 0 && a.c == 0)
+        return finish<F>(a.neg && b.neg, C(0), a.e < b.e ? a.e : b.e, false);
+    if (a.e < b.e)
+    {
+        const auto t = a;
+        a = b;
+        b = t;
+    }
+    if (a.c == 0) // b is exact at its smaller exponent
+        return finish<F>(b.neg, b.c, b.e, false);
+
+    int e = b.e;
+    C ca = a.c, cb = b.c;
+    bool sticky = false;
+    const int d = a.e - b.e;
+    if (d)
+    {
+        // Scale a up to at most F::digits + 2 digits, shift the rest of the distance out of b
+        int s = F::digits + 2 - digits(ca);
+        if (s > d)
+            s = d;
+        ca = ca * (C)pow10[s];
+        if (s < d)
+        {
+            // All of b below the last guard digit only counts as sticky
+            C rem = b.c;
+            cb = d - s > F::digits ? 0 : div10(cb, d - s, rem);
+            sticky = rem != 0;
+        }
+        e = a.e - s;
+    }
+
+    if (a.neg == b.neg)
+        return finish<F>(a.neg, ca + cb, e, sticky);
+
+    // Digits shifted out of b make it larger than what is left: subtract one more and keep the rest sticky
+    if (sticky)
+        cb++;
+    if (ca > cb)
+        return finish<F>(a.neg, ca - cb, e, sticky);
+    if (cb > ca)
+        return finish<F>(b.neg, cb - ca, e, sticky);
+    return finish<F>(false, C(0), e, false);
+}
+
+/// <summary>
+/// 128 x 128 bit product as four 64-bit words, least significant first
+/// </summary>
+inline void mul256(u128 a, u128 b, unsigned long long w[4])
+{
+    const unsigned long long a0 = (unsigned long long)a, a1 = (unsigned long long)(a >> 64);
+    const unsigned long long b0 = (unsigned long long)b, b1 = (unsigned long long)(b >> 64);
+    const u128 p00 = (u128)a0 * b0, p01 = (u128)a0 * b1, p10 = (u128)a1 * b0, p11 = (u128)a1 * b1;
+    const u128 mid = (p00 >> 64) + (unsigned long long)p01 + (unsigned long long)p10;
+    const u128 high = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+    w[0] = (unsigned long long)p00;
+    w[1] = (unsigned long long)mid;
+    w[2] = (unsigned long long)high;
+    w[3] = (unsigned long long)(high >> 64);
+}
+
+/// <summary>
+/// a x b; a coefficient that is a power of ten only moves the exponent, products that fit 128 bits are
+/// rounded directly and only the widest decimal128 products take the 256-bit path
+/// </summary>
+template <typename F>
+typename F::unpacked mul(const typename F::unpacked &a, const typename F::unpacked &b)
+{
+    const bool neg = a.neg != b.neg;
+    if (a.cls || b.cls)
+    {
+        if (a.cls == quiet_nan || b.cls == quiet_nan || (a.cls == infinite && b.c == 0 && !b.cls) || (b.cls == infinite && a.c == 0 && !a.cls))
+            return make_nan<F>();
+        typename F::unpacked u;
+        u.cls = infinite;
+        u.neg = neg;
+        return u;
+    }
+    if (a.c == 1)
+        return finish<F>(neg, b.c, a.e + b.e, false);
+    if (b.c == 1)
+        return finish<F>(neg, a.c, a.e + b.e, false);
+
+    // Always taken by decimal64, whose coefficients are below 2^54
+    if ((((u128)a.c | b.c) >> 64) == 0)
+        return finish<F>(neg, (u128)a.c * b.c, a.e + b.e, false);
+
+    unsigned long long w[4];
+    mul256(a.c, b.c, w);
+    if ((w[2] | w[3]) == 0)
+        return finish<F>(neg, (u128)w[1] << 64 | w[0], a.e + b.e, false);
+
+    // Drop digits, keeping only a sticky bit of them, down to at most 38 digits: that fits 128 bits and
+    // leaves more than the two rounding digits. The bit length bounds the digit count from above
+    const int bits = w[3] ? 256 - __builtin_clzll(w[3]) : 192 - __builtin_clzll(w[2]);
+    int drop = ((bits * 1233) >> 12) + 1 - 38;
+    int e = a.e + b.e + drop;
+    bool sticky = false;
+    while (drop > 0)
+    {
+        const int k = drop < 19 ? drop : 19; // 10^k divides a word at a time
+        const unsigned long long p = (unsigned long long)pow10[k];
+        u128 rem = 0;
+        for (int i = 3; i >= 0; i--)
+        {
+            const u128 cur = rem << 64 | w[i];
+            w[i] = (unsigned long long)(cur / p);
+            rem = cur % p;
+        }
+        sticky = sticky || rem;
+        drop -= k;
+    }
+    return finish<F>(neg, (u128)w[1] << 64 | w[0], e, sticky);
+}
+
+/// <summary>
+/// a / b; the quotient is developed in decimal chunks that keep the partial remainder within 128 bits,
+/// one more digit than the precision, the remainder is the sticky bit
+/// An exact quotient takes the exponent closest to the preferred one, a.e - b.e
+/// </summary>
+template <typename F>
+typename F::unpacked div(const typename F::unpacked &a, const typename F::unpacked &b)
+{
+    const bool neg = a.neg != b.neg;
+    if (a.cls || b.cls)
+    {
+        if (a.cls == quiet_nan || b.cls == quiet_nan || (a.cls == infinite && b.cls == infinite))
+            return make_nan<F>();
+        if (a.cls == infinite)
+        {
+            typename F::unpacked u;
+            u.cls = infinite;
+            u.neg = neg;
+            return u;
+        }
+        return finish<F>(neg, (u128)0, -F::bias, false); // Finite / infinity
+    }
+    if (b.c == 0)
+    {
+        if (a.c == 0)
+            return make_nan<F>();
+        typename F::unpacked u;
+        u.cls = infinite;
+        u.neg = neg;
+        return u;
+    }
+    const int preferred = a.e - b.e;
+    if (a.c == 0)
+        return finish<F>(neg, (u128)0, preferred, false);
+    if (b.c == 1)
+        return finish<F>(neg, a.c, preferred, false);
+
+    // F::digits + 1 digits of quotient at least
+    int k = F::digits + 1 + digits(b.c) - digits(a.c);
+    if (k < 0)
+        k = 0;
+    const int chunk = 38 - digits(b.c);
+
+    u128 q = a.c / b.c;
+    u128 r = a.c % b.c;
+    for (int left = k; left > 0;)
+    {
+        const int j = left < chunk ? left : chunk;
+        r = r * pow10[j];
+        q = q * pow10[j] + r / b.c;
+        r = r % b.c;
+        left -= j;
+    }
+
+    int e = preferred - k;
+    if (r == 0)
+    {
+        // Exact: remove trailing zeros down to the preferred exponent
+        while (e < preferred && q % 10 == 0)
+        {
+            q = q / 10;
+            e++;
+        }
+    }
+    return finish<F>(neg, q, e, r != 0);
+}
+
+/// <summary>
+/// Compare the values of a and b: -1, 0 or 1; NaN compares as unordered, 2
+/// </summary>
+template <typename C>
+int compare(const Unpacked<C> &a, const Unpacked<C> &b)
+{
+    if (a.cls == quiet_nan || b.cls == quiet_nan)
+        return 2;
+    const int sa = a.cls == infinite || a.c ? (a.neg ? -1 : 1) : 0;
+    const int sb = b.cls == infinite || b.c ? (b.neg ? -1 : 1) : 0;
+    if (sa != sb)
+        return sa < sb ? -1 : 1;
+    if (sa == 0)
+        return 0;
+    int m;
+    if (a.cls == infinite || b.cls == infinite)
+        m = a.cls == b.cls ? 0 : a.cls == infinite ? 1 : -1;
+    else
+    {
+        // Adjusted exponents order the magnitudes, equal ones leave the coefficients to align
+        const int da = digits(a.c), db = digits(b.c);
+        const int adj_a = a.e + da, adj_b = b.e + db;
+        if (adj_a != adj_b)
+            m = adj_a < adj_b ? -1 : 1;
+        else
+        {
+            const C ca = da < db ? a.c * (C)pow10[db - da] : a.c;
+            const C cb = db < da ? b.c * (C)pow10[da - db] : b.c;
+            m = ca == cb ? 0 : ca < cb ? -1 : 1;
+        }
+    }
+    return sa * m;
+}
+
+/// <summary>
+/// Correctly rounded conversion of a long double, from its decimal expansion by the C library
+/// </summary>
+template <typename F>
+typename F::unpacked from_long_double(long double v)
+{
+    typename F::unpacked u;
+    u.neg = std::signbit(v);
+    if (std::isnan(v))
+        u.cls = quiet_nan;
+    else if (std::isinf(v))
+        u.cls = infinite;
+    else if (v != 0)
+    {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%.*Le", F::digits - 1, std::fabs(v));
+        for (const char *p = buf; *p != 'e'; p++)
+            if (*p != '.')
+                u.c = u.c * 10 + (*p - '0');
+        u = finish<F>(u.neg, u.c, std::atoi(std::strchr(buf, 'e') + 1) - (F::digits - 1), false);
+    }
+    return u;
+}
+
+template <typename C>
+long double to_long_double(const Unpacked<C> &u)
+{
+    if (u.cls == quiet_nan)
+        return NAN;
+    if (u.cls == infinite)
+        return u.neg ? -INFINITY : INFINITY;
+    char buf[64], *p = buf + sizeof(buf);
+    *--p = 0;
+    C c = u.c;
+    do
+    {
+        *--p = char('0' + int(c % 10));
+        c /= 10;
+    } while (c);
+    char text[80];
+    std::snprintf(text, sizeof(text), "%s%se%d", u.neg ? "-" : "", p, u.e);
+    return std::strtold(text, nullptr);
+}
+} // namespace bid
+
+/// <summary>
+/// IEEE 754 decimal floating point number in the BID encoding, the bits are those of the standard format
+/// Each operation decodes its operands, works on the integer coefficients and encodes the rounded result
+/// </summary>
+template <typename F>
+class Bid
+{
+public:
+    using bits_t = typename F::bits_t;
+    bits_t bits = F::encode(typename F::unpacked());
+
+    Bid() = default;
+    Bid(int v)
+    {
+        typename F::unpacked u;
+        u.neg = v < 0;
+        u.c = v < 0 ? -(long long)v : v;
+        bits = F::encode(u);
+    }
+    Bid(double v) : Bid((long double)v) {}
+    Bid(long double v) : bits(F::encode(bid::from_long_double<F>(v))) {}
+    explicit operator long double() const { return bid::to_long_double(unpack()); }
+    explicit operator double() const { return double(bid::to_long_double(unpack())); }
+
+    typename F::unpacked unpack() const { return F::decode(bits); }
+    static Bid pack(const typename F::unpacked &u)
+    {
+        Bid b;
+        b.bits = F::encode(u);
+        return b;
+    }
+
+    friend Bid operator+(const Bid &a, const Bid &b) { return pack(bid::add<F>(a.unpack(), b.unpack())); }
+    friend Bid operator-(const Bid &a, const Bid &b) { return a + -b; }
+    friend Bid operator-(const Bid &a)
+    {
+        Bid r = a;
+        r.bits ^= (bits_t)1 << (8 * sizeof(bits_t) - 1);
+        return r;
+    }
+    friend Bid operator*(const Bid &a, const Bid &b) { return pack(bid::mul<F>(a.unpack(), b.unpack())); }
+    friend Bid operator/(const Bid &a, const Bid &b) { return pack(bid::div<F>(a.unpack(), b.unpack())); }
+
+    friend bool operator==(const Bid &a, const Bid &b) { return bid::compare(a.unpack(), b.unpack()) == 0; }
+    friend bool operator!=(const Bid &a, const Bid &b) { return bid::compare(a.unpack(), b.unpack()) != 0; }
+    friend bool operator<(const Bid &a, const Bid &b) { return bid::compare(a.unpack(), b.unpack()) == -1; }
+    friend bool operator<=(const Bid &a, const Bid &b)
+    {
+        const int c = bid::compare(a.unpack(), b.unpack());
+        return c == -1 || c == 0;
+    }
+    friend bool operator>(const Bid &a, const Bid &b) { return bid::compare(a.unpack(), b.unpack()) == 1; }
+    friend bool operator>=(const Bid &a, const Bid &b)
+    {
+        const int c = bid::compare(a.unpack(), b.unpack());
+        return c == 1 || c == 0;
+    }
+};
+
+using Dec64 = Bid<bid::Format64>;
+using Dec128 = Bid<bid::Format128>;
+
+/// <summary>
+/// a x (1 + 10^-k) as a + a x 10^-k, the same exact value rounded once, without the multiplication
+/// </summary>
+template <typename F>
+inline Bid<F> mul_1p10(const Bid<F> &a, const Bid<F> &, int k)
+{
+    auto s = a.unpack();
+    const auto u = s;
+    s.e -= k;
+    return Bid<F>::pack(bid::add<F>(u, s));
+}
+
+/// <summary>
+/// Traits shared by decimal64 and decimal128; split() and scale() only move the exponent
+/// Depth: the remainder after depth digits is below 10^-(depth-1), its r^2/2 error under 10^-(digits-1)
+/// </summary>
+template <typename F, typename W, int Depth, int Newton>
+struct bid_traits
+{
+    using T = Bid<F>;
+    using wide = W;
+    static constexpr int radix = 10;
+    static constexpr int depth = Depth;
+    static constexpr int newton = Newton;
+
+    static T epsilon()
+    {
+        typename F::unpacked u;
+        u.c = 1;
+        u.e = 1 - F::digits;
+        return T::pack(u);
+    }
+    static T abs(T x)
+    {
+        x.bits &= ~((typename F::bits_t)1 << (8 * sizeof(x.bits) - 1));
+        return x;
+    }
+    static bool isfinite(const T &x) { return x.unpack().cls == bid::finite; }
+    static bool isnan(const T &x) { return x.unpack().cls == bid::quiet_nan; }
+    static bool signbit(const T &x) { return x.unpack().neg; }
+    static T split(const T &x, int &e)
+    {
+        typename F::unpacked u = x.unpack();
+        e = 0;
+        if (u.cls || u.c == 0)
+            return x;
+        const int nd = bid::digits(u.c);
+        e = u.e + nd;
+        u.e = -nd;
+        return T::pack(u);
+    }
+    static T scale(const T &x, int e)
+    {
+        typename F::unpacked u = x.unpack();
+        if (u.cls)
+            return x;
+        return T::pack(bid::finish<F>(u.neg, u.c, u.e + e, false));
+    }
+    static double to_double(const T &x)
+    {
+        const typename F::unpacked u = x.unpack();
+        if (u.cls)
+            return u.cls == bid::quiet_nan ? NAN : u.neg ? -INFINITY : INFINITY;
+        return (u.neg ? -1 : 1) * double(u.c) * std::pow(10.0, u.e);
+    }
+};
+
+// decimal128 has more digits than any binary type here, so its tables are generated in decimal128 itself
+template <> struct num_traits<Dec64> : bid_traits<bid::Format64, long double, 9, 6> {};
+template <> struct num_traits<Dec128> : bid_traits<bid::Format128, Dec128, 18, 7> {};
+
+#endif // __SIZEOF_INT128__
@@ -0,0 +1,789 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "calcsim.h"
+
+// The methods of sqrt.cpp, log.cpp and trig.cpp as microcode of the calculator CPU in calcsim.h
+// Each routine is a sequence of machine instructions; C++ only sequences them, every decision and
+// every loop goes through a branch instruction of the machine, so the cycle count is that of the microcode
+
+using R = Machine;
+
+namespace
+{
+constexpr int depth = 9; // Pseudo-division digits, as for the 16-digit decimal number types
+
+/// <summary>
+/// Fixed point word of v with frac fraction digits, rounded
+/// </summary>
+R::Word word(long double v, int frac)
+{
+    unsigned long long n = (unsigned long long)std::llround(v * std::pow(10.0L, frac));
+    R::Word w{};
+    for (int i = 0; i < R::digits; i++, n /= 10)
+        w[i] = (unsigned char)(n % 10);
+    return w;
+}
+
+/// <summary>
+/// Constants of the microcode, as they would be burned into the ROM
+/// </summary>
+struct Rom
+{
+    R::Word ln_mul[depth];     // ln(1 + 10^-j), Q1.15
+    R::Word atan_pow[depth];   // atan(10^-j), Q1.15
+    R::Word ln10;              // Q1.15
+    R::Word ln10_q4;           // Q4.12
+    R::Word ln10_q3;           // Q3.13
+    R::Word exp_max;           // 230, Q3.13: above it e^x needs a 3-digit exponent
+    R::Word pi_q3[3];          // pi x 10^k, Q3.13
+    R::Word pio2_q3, pio4_q3;  // Q3.13
+    R::Word pio2;              // Q1.15
+    R::Word sqrt_guess[2][100]; // sqrt of d.d and of 0.dd, from the two leading digits, Q1.15
+
+    Rom()
+    {
+        const long double pi = 3.141592653589793238462643383279503L;
+        for (int j = 0; j < depth; j++)
+        {
+            ln_mul[j] = word(std::log1p(std::pow(10.0L, -j)), 15);
+            atan_pow[j] = word(std::atan(std::pow(10.0L, -j)), 15);
+        }
+        ln10 = word(std::log(10.0L), 15);
+        ln10_q4 = word(std::log(10.0L), 12);
+        ln10_q3 = word(std::log(10.0L), 13);
+        exp_max = word(230, 13);
+        for (int k = 0; k < 3; k++)
+            pi_q3[k] = word(pi * std::pow(10.0L, k), 13);
+        pio2_q3 = word(pi / 2, 13);
+        pio4_q3 = word(pi / 4, 13);
+        pio2 = word(pi / 2, 15);
+        for (int i = 0; i < 100; i++)
+        {
+            sqrt_guess[0][i] = word(std::sqrt((i + 0.5L) / 10), 15);
+            sqrt_guess[1][i] = word(std::sqrt((i + 0.5L) / 100), 15);
+        }
+    }
+};
+
+const Rom &rom()
+{
+    static const Rom r;
+    return r;
+}
+
+/// <summary>
+/// d = d x 10^-n, through the shift unit under the loop counter
+/// </summary>
+void shift_right(R &m, R::Reg d, int n)
+{
+    for (m.set_count(n); m.loop();)
+        m.shr(d, R::W);
+}
+
+/// <summary>
+/// C into A, the mantissa as Q1.15, and B, the exponent in X and the sign in S
+/// </summary>
+void unpack(R &m)
+{
+    m.call();
+    m.clear(R::A, R::W);
+    m.copy(R::A, R::C, R::MANT);
+    m.shl(R::A, R::W);
+    m.clear(R::B, R::W);
+    m.copy(R::B, R::C, R::X);
+    m.copy(R::B, R::C, R::S);
+    m.ret();
+}
+
+/// <summary>
+/// A x 10^B.X, A read as Q1.15, with the sign in B.S into C: normalized and rounded to the 12 digits of the display
+/// </summary>
+void pack(R &m)
+{
+    m.call();
+    m.clear(R::C, R::W);
+    m.test_zero(R::A, R::W);
+    if (m.jnc())
+    {
+        m.set_p(15);
+        for (;;)
+        {
+            m.test_zero(R::A, m.P());
+            if (m.jnc())
+                break;
+            m.shl(R::A, R::W);
+            m.dec(R::B, R::X);
+        }
+        // Round on digit 3, the first one below the display
+        m.clear(R::E, R::W);
+        m.set_p(3);
+        m.load_digit(R::E, 5);
+        m.add(R::A, R::A, R::E, R::W);
+        if (m.jc()) // Rounded up to 10
+        {
+            m.shr(R::A, R::W);
+            m.set_p(15);
+            m.load_digit(R::A, 1);
+            m.inc(R::B, R::X);
+        }
+        m.shr(R::A, R::W);
+        m.copy(R::C, R::A, R::MANT);
+        m.copy(R::C, R::B, R::X);
+        m.copy(R::C, R::B, R::S);
+    }
+    m.ret();
+}
+
+/// <summary>
+/// A = A / E for positive A and nonzero E, by restoring division one quotient digit at a time
+/// The quotient is Q1.15 read with the exponent F.X, which is adjusted for the normalization of the operands
+/// </summary>
+void fdiv(R &m)
+{
+    m.call();
+    m.test_zero(R::A, R::W);
+    if (m.jc())
+    {
+        m.ret();
+        return;
+    }
+    m.set_p(15);
+    for (;;)
+    {
+        m.test_zero(R::E, m.P());
+        if (m.jnc())
+            break;
+        m.shl(R::E, R::W);
+        m.inc(R::F, R::X);
+    }
+    for (;;)
+    {
+        m.test_zero(R::A, m.P());
+        if (m.jnc())
+            break;
+        m.shl(R::A, R::W);
+        m.dec(R::F, R::X);
+    }
+    // Both in [1, 10), as Q2.14 so that the remainder times 10 fits
+    m.shr(R::A, R::W);
+    m.shr(R::E, R::W);
+    m.clear(R::G, R::W);
+    for (;;)
+    {
+        for (;;)
+        {
+            m.compare(R::A, R::E, R::W);
+            if (m.jc())
+                break;
+            m.sub(R::A, R::A, R::E, R::W);
+            m.inc(R::G, m.P());
+        }
+        m.shl(R::A, R::W);
+        m.test_p(0);
+        if (m.jc())
+            break;
+        m.dec_p();
+    }
+    m.copy(R::A, R::G, R::W);
+    m.ret();
+}
+
+/// <summary>
+/// A x 10^F.X into A as fixed point Q1.15, for F.X <= 0
+/// </summary>
+void fix(R &m)
+{
+    m.call();
+    for (;;)
+    {
+        m.test_zero(R::F, R::X);
+        if (m.jc())
+            break;
+        m.shr(R::A, R::W);
+        m.inc(R::F, R::X);
+    }
+    m.ret();
+}
+
+/// <summary>
+/// A x 10^B.X into A as Q3.13, false if |x| >= 1000 does not fit
+/// </summary>
+bool to_q3(R &m)
+{
+    m.call();
+    m.copy(R::F, R::B, R::X);
+    m.dec(R::F, R::X);
+    m.dec(R::F, R::X);
+    for (;;)
+    {
+        m.test_zero(R::F, R::X);
+        if (m.jc())
+            break;
+        m.set_p(2);
+        m.test_ge(R::F, 5);
+        if (m.jnc())
+        {
+            m.ret();
+            return false;
+        }
+        m.shr(R::A, R::W);
+        m.inc(R::F, R::X);
+    }
+    m.ret();
+    return true;
+}
+
+/// <summary>
+/// True for an exponent B.X below -9, where tan(x) and atan(x) are x to the precision of the display
+/// Leaves the pointer on the top exponent digit
+/// </summary>
+bool tiny(R &m)
+{
+    m.call();
+    m.clear(R::H, R::W);
+    m.set_p(0);
+    m.load_digit(R::H, 9);
+    m.add(R::H, R::H, R::B, R::X);
+    m.set_p(2);
+    m.test_ge(R::H, 5);
+    m.ret();
+    return m.jc();
+}
+
+void error(R &m)
+{
+    m.clear(R::C, R::W);
+}
+
+/// <summary>
+/// SQRT: Newton's iteration of sqrt1(), the exponent halved as 5e/10
+/// </summary>
+void key_sqrt(R &m)
+{
+    m.test_zero(R::C, R::S);
+    if (m.jnc())
+        return error(m); // Error: Invalid input value
+    m.test_zero(R::C, R::MANT);
+    if (m.jc())
+        return;
+    unpack(m);
+
+    // An odd exponent leaves a 5 in the last digit of 5e: take the mantissa one digit down and e one up
+    // 5e is formed in the 4-digit field X4, sign extended, so that it does not overflow
+    for (;;)
+    {
+        m.clear(R::H, R::W);
+        m.copy(R::H, R::B, R::X);
+        m.set_p(2);
+        m.test_ge(R::B, 5);
+        if (m.jc())
+        {
+            m.set_p(3);
+            m.load_digit(R::H, 9);
+        }
+        m.copy(R::E, R::H, R::X4);
+        for (int i = 0; i < 4; i++)
+            m.add(R::H, R::H, R::E, R::X4);
+        m.set_p(0);
+        m.test_zero(R::H, m.P());
+        if (m.jc())
+            break;
+        m.shr(R::A, R::W);
+        m.inc(R::B, R::X);
+    }
+    m.shr(R::H, R::X4);
+    m.copy(R::B, R::H, R::X);
+
+    // Mantissa in [0.1, 10); the initial guess comes from a ROM table on its two leading digits
+    m.copy(R::D, R::A, R::W);
+    m.set_p(15);
+    m.test_zero(R::D, m.P());
+    const int small = m.jc();
+    m.set_p(small ? 14 : 15);
+    const int hi = m.dispatch(R::D);
+    m.dec_p();
+    const int lo = m.dispatch(R::D);
+    m.rom(R::H, rom().sqrt_guess[small][10 * hi + lo]);
+
+    for (m.set_count(6); m.loop();)
+    {
+        m.copy(R::A, R::D, R::W);
+        m.copy(R::E, R::H, R::W);
+        m.clear(R::F, R::X);
+        fdiv(m);
+        fix(m); // m/last, in [0.3, 3.3) for a guess within 3%
+        m.add(R::A, R::A, R::H, R::W);
+        // Halved as one digit down and times 5
+        m.shr(R::A, R::W);
+        m.copy(R::E, R::A, R::W);
+        for (int i = 0; i < 4; i++)
+            m.add(R::A, R::A, R::E, R::W);
+        // Converged once the new result differs from the last one in the last digit only
+        m.sub(R::E, R::H, R::A, R::W);
+        if (m.jc())
+            m.sub(R::E, R::A, R::H, R::W);
+        m.copy(R::H, R::A, R::W);
+        m.test_zero(R::E, {1, 15});
+        if (m.jc())
+            break;
+    }
+    m.copy(R::A, R::H, R::W);
+    pack(m);
+}
+
+/// <summary>
+/// LN: pseudo-division of the mantissa, the logarithms of its digits summed, e x ln(10) added, as ln1()
+/// </summary>
+void key_ln(R &m)
+{
+    m.set_flag(0, false);
+    m.test_zero(R::C, R::S);
+    if (m.jnc())
+        return error(m); // Error: Invalid input value
+    m.test_zero(R::C, R::MANT);
+    if (m.jc())
+        return error(m);
+    unpack(m);
+
+    // Digit j counts the factors 1 + 10^-j, each a shift and an add, that keep the mantissa below 10
+    m.clear(R::D, R::W);
+    for (m.set_p(0);; m.inc_p())
+    {
+        for (;;)
+        {
+            m.copy(R::E, R::A, R::W);
+            shift_right(m, R::E, m.p);
+            m.add(R::E, R::A, R::E, R::W);
+            if (m.jc())
+                break;
+            m.copy(R::A, R::E, R::W);
+            m.inc(R::D, m.P());
+        }
+        m.test_p(depth - 1);
+        if (m.jc())
+            break;
+    }
+
+    // ln(10/a) ~ (10 - a)/10, where 10 - a is the word negated
+    m.negate(R::A, R::A, R::W);
+    m.shr(R::A, R::W);
+    for (m.set_p(depth - 1);; m.dec_p())
+    {
+        m.rom(R::E, rom().ln_mul[m.p]);
+        for (;;)
+        {
+            m.test_zero(R::D, m.P());
+            if (m.jc())
+                break;
+            m.add(R::A, R::A, R::E, R::W);
+            m.dec(R::D, m.P());
+        }
+        m.test_p(0);
+        if (m.jc())
+            break;
+    }
+    m.rom(R::E, rom().ln10);
+    m.sub(R::A, R::E, R::A, R::W); // ln(mantissa)
+
+    // Q4.12 to make room for e x ln(10), formed in F one exponent digit at a time
+    shift_right(m, R::A, 3);
+    m.set_p(2);
+    m.test_ge(R::B, 5);
+    if (m.jc())
+    {
+        m.set_flag(0, true);
+        m.negate(R::B, R::B, R::X);
+    }
+    m.rom(R::E, rom().ln10_q4);
+    m.clear(R::F, R::W);
+    for (m.set_p(1);; m.dec_p())
+    {
+        m.shl(R::F, R::W);
+        for (;;)
+        {
+            m.test_zero(R::B, m.P());
+            if (m.jc())
+                break;
+            m.add(R::F, R::F, R::E, R::W);
+            m.dec(R::B, m.P());
+        }
+        m.test_p(0);
+        if (m.jc())
+            break;
+    }
+    if (m.jf(0))
+    {
+        m.sub(R::A, R::F, R::A, R::W); // e < 0: the result is -(|e| x ln(10) - ln(mantissa))
+        m.set_p(15);
+        m.load_digit(R::B, 9);
+        m.jump();
+    }
+    else
+        m.add(R::A, R::A, R::F, R::W);
+    m.clear(R::B, R::X);
+    m.set_p(0);
+    m.load_digit(R::B, 3);
+    pack(m);
+}
+
+/// <summary>
+/// EXP: ln(10) and ln(1 + 10^-j) subtracted digit by digit, the factors multiplied back as shifts and adds, as exp1()
+/// </summary>
+void key_exp(R &m)
+{
+    m.set_flag(0, false);
+    unpack(m);
+    m.set_p(15);
+    m.test_ge(R::B, 5);
+    if (m.jc())
+        m.set_flag(0, true);
+    if (!to_q3(m))
+        return error(m); // Error: Out of range
+    m.rom(R::E, rom().exp_max);
+    m.compare(R::E, R::A, R::W);
+    if (m.jc())
+        return error(m); // Error: Out of range, or underflow for a negative x
+
+    // Digit 0 counts ln(10), which is the decimal exponent of the result
+    m.clear(R::B, R::W);
+    m.rom(R::E, rom().ln10_q3);
+    for (;;)
+    {
+        m.compare(R::A, R::E, R::W);
+        if (m.jc())
+            break;
+        m.sub(R::A, R::A, R::E, R::W);
+        m.inc(R::B, R::X);
+    }
+    m.shl(R::A, R::W);
+    m.shl(R::A, R::W);
+
+    m.clear(R::D, R::W);
+    for (m.set_p(0);; m.inc_p())
+    {
+        m.rom(R::E, rom().ln_mul[m.p]);
+        for (;;)
+        {
+            m.compare(R::A, R::E, R::W);
+            if (m.jc())
+                break;
+            m.sub(R::A, R::A, R::E, R::W);
+            m.inc(R::D, m.P());
+        }
+        m.test_p(depth - 1);
+        if (m.jc())
+            break;
+    }
+
+    // e^r ~ 1 + r, then the factors multiplied in from LSB to MSB: a = a + (a >> j)
+    m.clear(R::E, R::W);
+    m.set_p(15);
+    m.load_digit(R::E, 1);
+    m.add(R::A, R::A, R::E, R::W);
+    for (m.set_p(depth - 1);; m.dec_p())
+    {
+        for (;;)
+        {
+            m.test_zero(R::D, m.P());
+            if (m.jc())
+                break;
+            m.copy(R::E, R::A, R::W);
+            shift_right(m, R::E, m.p);
+            m.add(R::A, R::A, R::E, R::W);
+            m.dec(R::D, m.P());
+        }
+        m.test_p(0);
+        if (m.jc())
+            break;
+    }
+
+    if (m.jf(0)) // e^-x = 1/e^x
+    {
+        m.copy(R::E, R::A, R::W);
+        m.clear(R::A, R::W);
+        m.set_p(15);
+        m.load_digit(R::A, 1);
+        m.clear(R::F, R::X);
+        fdiv(m);
+        m.sub(R::B, R::F, R::B, R::X);
+    }
+    pack(m);
+}
+
+/// <summary>
+/// TAN: the angle reduced to an octant, pseudo-divided by atan(10^-j) and the vector (1, r) rotated back, as tan1()
+/// </summary>
+void key_tan(R &m)
+{
+    m.set_flag(0, false); // Odd quadrant
+    m.set_flag(1, false); // Mirrored octant
+    m.set_flag(2, false); // Negative
+    unpack(m);
+    m.set_p(15);
+    m.test_ge(R::B, 5);
+    if (m.jc())
+        m.set_flag(2, true);
+    if (tiny(m))
+        return; // tan(x) = x
+    if (!to_q3(m))
+        return error(m); // Error: Out of range
+
+    // tan() has the period pi: subtract pi x 10^k while it fits, for k = 2, 1, 0
+    for (int k = 2; k >= 0; k--)
+    {
+        m.rom(R::E, rom().pi_q3[k]);
+        for (;;)
+        {
+            m.compare(R::A, R::E, R::W);
+            if (m.jc())
+                break;
+            m.sub(R::A, R::A, R::E, R::W);
+        }
+    }
+    // tan(r + pi/2) = -1/tan(r) and tan(r) = 1/tan(pi/2 - r)
+    m.rom(R::E, rom().pio2_q3);
+    m.compare(R::A, R::E, R::W);
+    if (m.jnc())
+    {
+        m.sub(R::A, R::A, R::E, R::W);
+        m.set_flag(0, true);
+    }
+    m.rom(R::E, rom().pio4_q3);
+    m.compare(R::E, R::A, R::W);
+    if (m.jc())
+    {
+        m.rom(R::E, rom().pio2_q3);
+        m.sub(R::A, R::E, R::A, R::W);
+        m.set_flag(1, true);
+    }
+    m.shl(R::A, R::W);
+    m.shl(R::A, R::W);
+
+    m.clear(R::D, R::W);
+    for (m.set_p(0);; m.inc_p())
+    {
+        m.rom(R::E, rom().atan_pow[m.p]);
+        for (;;)
+        {
+            m.compare(R::A, R::E, R::W);
+            if (m.jc())
+                break;
+            m.sub(R::A, R::A, R::E, R::W);
+            m.inc(R::D, m.P());
+        }
+        m.test_p(depth - 1);
+        if (m.jc())
+            break;
+    }
+
+    // Vector (x, y) = (1, remainder) in (F, A): x -= y >> j and y += x >> j
+    m.clear(R::F, R::W);
+    m.set_p(15);
+    m.load_digit(R::F, 1);
+    for (m.set_p(depth - 1);; m.dec_p())
+    {
+        for (;;)
+        {
+            m.test_zero(R::D, m.P());
+            if (m.jc())
+                break;
+            m.copy(R::G, R::A, R::W);
+            shift_right(m, R::G, m.p);
+            m.copy(R::H, R::F, R::W);
+            shift_right(m, R::H, m.p);
+            m.sub(R::F, R::F, R::G, R::W);
+            m.add(R::A, R::A, R::H, R::W);
+            m.dec(R::D, m.P());
+        }
+        m.test_p(0);
+        if (m.jc())
+            break;
+    }
+
+    // y/x, or x/y in an odd quadrant or a mirrored octant but not both; negated in an odd quadrant
+    if (m.jf(0) != m.jf(1))
+        m.exchange(R::A, R::F, R::W);
+    m.copy(R::E, R::F, R::W);
+    m.test_zero(R::E, R::W);
+    if (m.jc())
+        return error(m); // Error: Invalid input value
+    m.clear(R::F, R::X);
+    fdiv(m);
+    m.clear(R::B, R::W);
+    m.copy(R::B, R::F, R::X);
+    if (m.jf(0) != m.jf(2))
+    {
+        m.set_p(15);
+        m.load_digit(R::B, 9);
+    }
+    pack(m);
+}
+
+/// <summary>
+/// ATAN: vectoring of (1, x) after folding |x| > 1 onto 1/|x|, the angles of the digits summed, as atan1() and polar()
+/// </summary>
+void key_atan(R &m)
+{
+    m.set_flag(0, false); // Folded
+    m.set_flag(1, false); // Negative
+    m.test_zero(R::C, R::MANT);
+    if (m.jc())
+        return;
+    unpack(m);
+    m.set_p(15);
+    m.test_ge(R::B, 5);
+    if (m.jc())
+        m.set_flag(1, true);
+
+    if (tiny(m))
+        return; // atan(x) = x
+
+    // atan(x) = pi/2 - atan(1/x) for |x| >= 1
+    m.copy(R::F, R::B, R::X);
+    m.test_ge(R::B, 5);
+    if (m.jnc())
+    {
+        m.set_flag(0, true);
+        m.copy(R::E, R::A, R::W);
+        m.clear(R::A, R::W);
+        m.set_p(15);
+        m.load_digit(R::A, 1);
+        m.negate(R::F, R::B, R::X);
+        fdiv(m);
+    }
+    fix(m);
+
+    // Vector (x, y) = (1, a) in (F, A): while y - (x >> j) stays positive, y -= x >> j and x += y >> j
+    m.clear(R::D, R::W);
+    m.clear(R::F, R::W);
+    m.set_p(15);
+    m.load_digit(R::F, 1);
+    for (m.set_p(0);; m.inc_p())
+    {
+        for (;;)
+        {
+            m.copy(R::G, R::F, R::W);
+            shift_right(m, R::G, m.p);
+            m.sub(R::H, R::A, R::G, R::W);
+            if (m.jc())
+                break;
+            m.copy(R::G, R::A, R::W);
+            shift_right(m, R::G, m.p);
+            m.add(R::F, R::F, R::G, R::W);
+            m.copy(R::A, R::H, R::W);
+            m.inc(R::D, m.P());
+        }
+        m.test_p(depth - 1);
+        if (m.jc())
+            break;
+    }
+
+    // The remainder y/x, then the angles of the digits from LSB to MSB
+    m.test_zero(R::A, R::W);
+    if (m.jnc())
+    {
+        m.copy(R::E, R::F, R::W);
+        m.clear(R::F, R::X);
+        fdiv(m);
+        fix(m);
+    }
+    for (m.set_p(depth - 1);; m.dec_p())
+    {
+        m.rom(R::E, rom().atan_pow[m.p]);
+        for (;;)
+        {
+            m.test_zero(R::D, m.P());
+            if (m.jc())
+                break;
+            m.add(R::A, R::A, R::E, R::W);
+            m.dec(R::D, m.P());
+        }
+        m.test_p(0);
+        if (m.jc())
+            break;
+    }
+    if (m.jf(0))
+    {
+        m.rom(R::E, rom().pio2);
+        m.sub(R::A, R::E, R::A, R::W);
+    }
+    m.clear(R::B, R::W);
+    if (m.jf(1))
+    {
+        m.set_p(15);
+        m.load_digit(R::B, 9);
+    }
+    pack(m);
+}
+
+/// <summary>
+/// Print the cycles one key takes over the inputs, the time at the clock and the largest relative error
+/// of the displayed result against long double
+/// </summary>
+template <typename Ref>
+void print_key(const char *name, void (*key)(R &), Ref ref, const std::vector<long double> &in, double khz)
+{
+    long total = 0, worst = 0;
+    long double err = 0;
+    for (long double x : in)
+    {
+        R m;
+        m.enter(x);
+        const long double keyed = m.display();
+        key(m);
+        total += m.cycles;
+        worst = std::max(worst, m.cycles);
+        const long double verif = ref(keyed);
+        err = std::max(err, std::fabs((m.display() - verif) / verif));
+    }
+
+    const double avg = double(total) / in.size();
+    std::cout << std::setw(6) << std::left << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << avg << std::setw(12) << worst << std::setprecision(1)
+              << std::setw(11) << avg / khz << std::setw(11) << worst / khz
+              << std::scientific << std::setprecision(1) << std::setw(11) << double(err) << "\n";
+}
+} // namespace
+
+/// <summary>
+/// Cycles per keypress of each function on the simulated calculator CPU, and the display latency
+/// at its clock in kHz, for one digit time per cycle
+/// </summary>
+void sim_report(double khz)
+{
+    const int count = 1000;
+    std::mt19937_64 gen(1);
+    auto uniform = [&gen](double lo, double hi) {
+        std::uniform_real_distribution<double> dist(lo, hi);
+        std::vector<long double> v(count);
+        for (auto &x : v)
+            x = dist(gen);
+        return v;
+    };
+    auto log_uniform = [&uniform](double lo, double hi) {
+        auto v = uniform(lo, hi);
+        for (auto &x : v)
+            x = std::pow(10.0L, x);
+        return v;
+    };
+
+    // The ranges of bench_cost(), so that the cycles compare with the cost model estimate
+    std::cout << "\n----- Calculator microcode: cycles per key, display latency at " << std::fixed << std::setprecision(0) << khz << " kHz -----\n";
+    std::cout << "key     cycles avg  cycles max     ms avg     ms max  max error\n";
+    print_key("SQRT", key_sqrt, [](long double x) { return std::sqrt(x); }, log_uniform(-2, 3), khz);
+    print_key("LN", key_ln, [](long double x) { return std::log(x); }, log_uniform(-2, 3), khz);
+    print_key("EXP", key_exp, [](long double x) { return std::exp(x); }, uniform(-10, 10), khz);
+    print_key("TAN", key_tan, [](long double x) { return std::tan(x); }, uniform(-1.5, 1.5), khz);
+    print_key("ATAN", key_atan, [](long double x) { return std::atan(x); }, uniform(-100, 100), khz);
+}
@@ -0,0 +1,285 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+/// <summary>
+/// Cycle-level model of a simple BCD calculator CPU, in the spirit of the HP-35
+///
+/// Eight registers of 16 BCD digits, digit 0 least significant, go through a digit-serial adder and
+/// a shift unit. An instruction works on a field of digits and takes one cycle to fetch and decode
+/// plus one cycle for each digit it passes through the adder or the shift unit; pointer, flag and
+/// branch instructions take one cycle. A ROM constant is read one digit per cycle
+///
+/// A number in a register has the display format:
+///   digit 15      sign of the mantissa, 0 or 9
+///   digits 14..3  12-digit mantissa, d.ddddddddddd
+///   digits 2..0   exponent in ten's complement, -99..99
+/// Microcode works on fixed point words in between, named Qi.f for i integer and f fraction digits
+/// </summary>
+class Machine
+{
+public:
+    static constexpr int digits = 16;
+    using Word = std::array<unsigned char, digits>;
+
+    enum Reg { A, B, C, D, E, F, G, H, regs }; // C holds x on entry and the result on exit
+
+    struct Field
+    {
+        int lo, hi;
+    };
+    static constexpr Field W{0, 15};     // Whole word
+    static constexpr Field MANT{3, 14};  // Mantissa
+    static constexpr Field X{0, 2};      // Exponent
+    static constexpr Field S{15, 15};    // Sign
+    static constexpr Field X4{0, 3};     // Exponent with one more digit, for intermediate values
+
+    Word r[regs] = {};
+    int p = 0;            // Digit pointer
+    int count = 0;        // Loop counter
+    bool carry = false;   // Carry or borrow out of the last operation, or the result of the last test
+    bool flag[4] = {};    // Status flags of the microcode
+    long cycles = 0;
+
+    Field P() const { return {p, p}; }
+
+    // Digit-serial instructions: one cycle to fetch and one per digit of the field
+    void clear(Reg d, Field f)
+    {
+        tick(f);
+        for (int i = f.lo; i <= f.hi; i++)
+            r[d][i] = 0;
+    }
+    void copy(Reg d, Reg s, Field f)
+    {
+        tick(f);
+        for (int i = f.lo; i <= f.hi; i++)
+            r[d][i] = r[s][i];
+    }
+    void exchange(Reg a, Reg b, Field f)
+    {
+        tick(f);
+        for (int i = f.lo; i <= f.hi; i++)
+            std::swap(r[a][i], r[b][i]);
+    }
+    void add(Reg d, Reg a, Reg b, Field f) // d = a + b, carry out of the field
+    {
+        tick(f);
+        int c = 0;
+        for (int i = f.lo; i <= f.hi; i++)
+        {
+            const int s = r[a][i] + r[b][i] + c;
+            c = s >= 10;
+            r[d][i] = (unsigned char)(s - 10 * c);
+        }
+        carry = c;
+    }
+    void sub(Reg d, Reg a, Reg b, Field f) // d = a - b, carry is the borrow
+    {
+        tick(f);
+        int c = 0;
+        for (int i = f.lo; i <= f.hi; i++)
+        {
+            const int s = r[a][i] - r[b][i] - c;
+            c = s < 0;
+            r[d][i] = (unsigned char)(s + 10 * c);
+        }
+        carry = c;
+    }
+    void negate(Reg d, Reg s, Field f) // d = 0 - s
+    {
+        tick(f);
+        int c = 0;
+        for (int i = f.lo; i <= f.hi; i++)
+        {
+            const int t = -r[s][i] - c;
+            c = t < 0;
+            r[d][i] = (unsigned char)(t + 10 * c);
+        }
+        carry = c;
+    }
+    void inc(Reg d, Field f) // d = d + 1, carry out of the field
+    {
+        tick(f);
+        int c = 1;
+        for (int i = f.lo; i <= f.hi; i++)
+        {
+            const int s = r[d][i] + c;
+            c = s >= 10;
+            r[d][i] = (unsigned char)(s - 10 * c);
+        }
+        carry = c;
+    }
+    void dec(Reg d, Field f) // d = d - 1, carry is the borrow
+    {
+        tick(f);
+        int c = 1;
+        for (int i = f.lo; i <= f.hi; i++)
+        {
+            const int s = r[d][i] - c;
+            c = s < 0;
+            r[d][i] = (unsigned char)(s + 10 * c);
+        }
+        carry = c;
+    }
+    void compare(Reg a, Reg b, Field f) // carry = a < b, as the borrow of a - b
+    {
+        tick(f);
+        int c = 0;
+        for (int i = f.lo; i <= f.hi; i++)
+            c = r[a][i] - r[b][i] - c < 0;
+        carry = c;
+    }
+    void test_zero(Reg s, Field f) // carry = the field is all zeros
+    {
+        tick(f);
+        carry = true;
+        for (int i = f.lo; i <= f.hi; i++)
+            carry = carry && r[s][i] == 0;
+    }
+
+    // Shift unit: one digit toward the most or the least significant end, a zero comes in
+    void shl(Reg d, Field f)
+    {
+        tick(f);
+        for (int i = f.hi; i > f.lo; i--)
+            r[d][i] = r[d][i - 1];
+        r[d][f.lo] = 0;
+    }
+    void shr(Reg d, Field f)
+    {
+        tick(f);
+        for (int i = f.lo; i < f.hi; i++)
+            r[d][i] = r[d][i + 1];
+        r[d][f.hi] = 0;
+    }
+
+    // One cycle instructions
+    void set_p(int n)
+    {
+        cycles++;
+        p = n;
+    }
+    void inc_p()
+    {
+        cycles++;
+        p++;
+    }
+    void dec_p()
+    {
+        cycles++;
+        p--;
+    }
+    void test_p(int n)
+    {
+        cycles++;
+        carry = p == n;
+    }
+    void load_digit(Reg d, int v) // Constant into the digit at the pointer
+    {
+        cycles++;
+        r[d][p] = (unsigned char)v;
+    }
+    void test_ge(Reg s, int v) // carry = the digit at the pointer is at least v
+    {
+        cycles++;
+        carry = r[s][p] >= v;
+    }
+    void set_flag(int i, bool v)
+    {
+        cycles++;
+        flag[i] = v;
+    }
+    bool jf(int i) // Jump if flag i is set
+    {
+        cycles++;
+        return flag[i];
+    }
+    bool jc() // Jump if carry
+    {
+        cycles++;
+        return carry;
+    }
+    bool jnc() // Jump if no carry
+    {
+        cycles++;
+        return !carry;
+    }
+    int dispatch(Reg s) // Ten-way jump on the digit at the pointer
+    {
+        cycles++;
+        return r[s][p];
+    }
+    void set_count(int n)
+    {
+        cycles++;
+        count = n;
+    }
+    bool loop() // Decrement the loop counter, jump while it had not run out
+    {
+        cycles++;
+        return count-- > 0;
+    }
+    void jump() { cycles++; }
+    void call() { cycles++; }
+    void ret() { cycles++; }
+
+    // ROM constant, read one digit per cycle
+    void rom(Reg d, const Word &w)
+    {
+        cycles += 1 + digits;
+        r[d] = w;
+    }
+
+    /// <summary>
+    /// Key in x: the display format of x rounded to 12 digits, into register C; no cycles
+    /// </summary>
+    void enter(long double x)
+    {
+        r[C] = Word();
+        if (x == 0)
+            return;
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%.11Le", std::fabs(x));
+        int i = 14;
+        for (const char *c = buf; *c != 'e'; c++)
+            if (*c != '.')
+                r[C][i--] = (unsigned char)(*c - '0');
+        const int e = std::atoi(std::strchr(buf, 'e') + 1);
+        const int t = e < 0 ? 1000 + e : e;
+        r[C][0] = (unsigned char)(t % 10);
+        r[C][1] = (unsigned char)(t / 10 % 10);
+        r[C][2] = (unsigned char)(t / 100);
+        r[C][15] = x < 0 ? 9 : 0;
+    }
+
+    /// <summary>
+    /// Value on the display, from register C
+    /// </summary>
+    long double display() const
+    {
+        long double m = 0;
+        for (int i = 14; i >= 3; i--)
+            m = m * 10 + r[C][i];
+        int e = r[C][2] * 100 + r[C][1] * 10 + r[C][0];
+        if (e >= 500)
+            e -= 1000;
+        const long double v = m * std::pow(10.0L, e - 11);
+        return r[C][15] ? -v : v;
+    }
+
+private:
+    void tick(Field f) { cycles += 1 + f.hi - f.lo + 1; }
+};
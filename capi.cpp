@@ -0,0 +1,79 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <algorithm>
+#include "methods.h"
+#include "simd.h"
+#include "nummethods.h"
+
+// C interface of the library, see nummethods.h
+
+namespace
+{
+/// <summary>
+/// Run a batch kernel over strided arrays: unit strides directly, others gathered into a buffer
+/// a chunk at a time and scattered back, which also makes in-place calls safe
+/// </summary>
+template <BatchKernel F>
+void strided(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    if (in_stride == 1 && out_stride == 1)
+        return F(in, out, count);
+
+    const size_t chunk = 256;
+    double x[chunk], y[chunk];
+    while (count)
+    {
+        const size_t n = std::min(count, chunk);
+        for (size_t i = 0; i < n; i++)
+            x[i] = in[ptrdiff_t(i) * in_stride];
+        F(x, y, n);
+        for (size_t i = 0; i < n; i++)
+            out[ptrdiff_t(i) * out_stride] = y[i];
+        in += ptrdiff_t(n) * in_stride;
+        out += ptrdiff_t(n) * out_stride;
+        count -= n;
+    }
+}
+} // namespace
+
+extern "C" {
+
+int nm_abi_version(void) { return NM_ABI_VERSION; }
+
+double nm_sqrt(double x) { return sqrt1(x); }
+double nm_ln(double x) { return ln1(x); }
+double nm_exp(double x) { return exp1(x); }
+double nm_tan(double x) { return tan1(x); }
+double nm_atan(double x) { return atan1(x); }
+
+void nm_sqrt_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    strided<sqrt1_batch>(in, in_stride, out, out_stride, count);
+}
+
+void nm_ln_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    strided<ln1_batch>(in, in_stride, out, out_stride, count);
+}
+
+void nm_exp_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    strided<exp1_batch>(in, in_stride, out, out_stride, count);
+}
+
+void nm_tan_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    strided<tan1_batch>(in, in_stride, out, out_stride, count);
+}
+
+void nm_atan_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count)
+{
+    strided<atan1_batch>(in, in_stride, out, out_stride, count);
+}
+
+} // extern "C"
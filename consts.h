@@ -0,0 +1,173 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include "numtraits.h"
+#include "tables.h"
+
+namespace series
+{
+/// <summary>
+/// Natural logarithm in any number type W, as ct::ln() does it in long double
+/// ln(x) = k*ln(2) + 2*atanh((m-1)/(m+1)), where x = m * 2^k and m is in [0.75, 1.5)
+/// </summary>
+template <typename W>
+W ln(W x)
+{
+    auto atanh = [](W z) {
+        W sum = 0;
+        W term = z;
+        for (int k = 1; k < 120; k += 2)
+        {
+            sum = sum + term / W(k);
+            term = term * z * z;
+        }
+        return sum;
+    };
+    const W ln2 = 2 * atanh(W(1) / W(3));
+
+    int e = 0;
+    while (x >= W(1.5)) { x = x / 2; e++; }
+    while (x < W(0.75)) { x = x * 2; e--; }
+
+    return W(e) * ln2 + 2 * atanh((x - 1) / (x + 1));
+}
+
+/// <summary>
+/// Arc tangent of |x| <= 1/5 in any number type W, from its Taylor series
+/// </summary>
+template <typename W>
+W atan(W x)
+{
+    W sum = 0;
+    W term = x;
+    for (int k = 1; k < 120; k += 2)
+    {
+        sum = sum + term / W(k);
+        term = -term * x * x;
+    }
+    return sum;
+}
+
+/// <summary>
+/// pi in any number type W, by Machin's formula: pi/4 = 4 atan(1/5) - atan(1/239)
+/// </summary>
+template <typename W>
+W pi()
+{
+    return 4 * (4 * atan(W(1) / W(5)) - atan(W(1) / W(239)));
+}
+
+/// <summary>
+/// 1/sqrt(a) of a in [1, 2] in any number type W, by Newton iteration from 1
+/// </summary>
+template <typename W>
+W rsqrt(W a)
+{
+    W r = 1;
+    for (int k = 0; k < 100; k++)
+        r = r * (W(3) - a * r * r) / 2;
+    return r;
+}
+} // namespace series
+
+/// <summary>
+/// Constant tables of the numerical methods in the number type T
+/// They are generated once, in the wide type of T, and rounded to T; where an algorithm steps by a
+/// table value the matching constant is computed from the value rounded to T, as tables.h does for double
+/// </summary>
+template <typename T>
+struct Consts
+{
+    static constexpr int N = 24; // More than the deepest digit recurrence of any type
+
+    T mul[N];   // Multipliers of ln(x) and exp(x): 10, 2, 1.1, 1.01, 1.001, ...
+    T logs[N];  // ln(mul[j])
+    T tens[N];  // Pseudo-rotation steps 10^-i
+    T tans[N];  // atan(tens[i])
+    T gain_delta[N]; // 1/sqrt(1 + tens[i]^2) - 1, the inverse of the growth of a pseudo-rotation step less one
+    T pow10[N]; // 10^i
+    T ln10;
+    T pi;
+    T pio2_hi, pio2_lo; // pi/2 = pio2_hi + pio2_lo
+
+    Consts();
+
+private:
+    void generate()
+    {
+        using W = typename num_traits<T>::wide;
+
+        W p = 1, q = 1; // 10^-j, 10^j
+        for (int j = 0; j < N; j++)
+        {
+            tens[j] = T(p);
+            pow10[j] = T(q);
+            if (j >= 2)
+                mul[j] = T(1 + p * 10);
+            p = p / 10;
+            q = q * 10;
+        }
+        mul[0] = T(10);
+        mul[1] = T(2);
+
+        const W w_pi = series::pi<W>();
+        for (int j = 0; j < N; j++)
+        {
+            logs[j] = T(series::ln(W(mul[j])));
+            tans[j] = j ? T(series::atan(W(tens[j]))) : T(w_pi / 4);
+            gain_delta[j] = T(series::rsqrt(1 + W(tens[j]) * W(tens[j])) - 1);
+        }
+        ln10 = logs[0];
+        pi = T(w_pi);
+        pio2_hi = T(w_pi / 2);
+        pio2_lo = T(w_pi / 2 - W(pio2_hi));
+    }
+};
+
+template <typename T>
+Consts<T>::Consts()
+{
+    generate();
+}
+
+/// <summary>
+/// double takes the entries it has in tables.h, and atan() of libm, so its results do not change
+/// </summary>
+template <>
+inline Consts<double>::Consts()
+{
+    generate();
+    for (int j = 0; j < int(sizeof(ln_mul) / sizeof(ln_mul[0])); j++)
+    {
+        mul[j] = ln_mul[j];
+        logs[j] = ln_logs[j];
+    }
+    for (int j = 0; j < N; j++)
+    {
+        pow10[j] = pow10_table[j];
+        tens[j] = 1 / pow10_table[j];
+        tans[j] = std::atan(tens[j]);
+        gain_delta[j] = ::gain_delta[j];
+    }
+    ln10 = ln_logs[0];
+    pi = 3.141592653589793;
+    pio2_hi = ::pio2_hi;
+    pio2_lo = ::pio2_lo;
+}
+
+/// <summary>
+/// Constant tables of T, generated at the first use
+/// </summary>
+template <typename T>
+const Consts<T> &consts()
+{
+    static const Consts<T> c;
+    return c;
+}
@@ -0,0 +1,225 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "numtraits.h"
+
+/// <summary>
+/// Number of arithmetic operations of each kind
+/// A shift is a multiplication or division by a power of ten: a decimal machine moves the digits, or
+/// the exponent, instead of running the multiplier. Multiplying or dividing by 2 or 5 is a few adds
+/// and a shift, see Counted::small_factor()
+/// </summary>
+struct OpCounts
+{
+    long add = 0;   // Additions and subtractions
+    long mul = 0;   // Multiplications
+    long div = 0;   // Divisions
+    long shift = 0; // Multiplications and divisions by 10^k
+    long cmp = 0;   // Comparisons
+
+    OpCounts &operator+=(const OpCounts &o)
+    {
+        add += o.add;
+        mul += o.mul;
+        div += o.div;
+        shift += o.shift;
+        cmp += o.cmp;
+        return *this;
+    }
+    friend OpCounts operator-(OpCounts a, const OpCounts &b)
+    {
+        a.add -= b.add;
+        a.mul -= b.mul;
+        a.div -= b.div;
+        a.shift -= b.shift;
+        a.cmp -= b.cmp;
+        return a;
+    }
+};
+
+/// <summary>
+/// Running totals of the operations on Counted values; take a copy before and subtract it after a call
+/// </summary>
+inline OpCounts op_counts;
+
+/// <summary>
+/// Instrumented number: a long double that counts each operation done on it in op_counts
+/// Its traits make it a decimal type, so the methods take the path of the calculator they model
+/// </summary>
+class Counted
+{
+public:
+    long double v = 0;
+
+    Counted() = default;
+    Counted(int x) : v(x) {}
+    Counted(double x) : v(x) {}
+    Counted(long double x) : v(x) {}
+    explicit operator double() const { return double(v); }
+    explicit operator long double() const { return v; }
+
+    /// <summary>
+    /// True for 10^k, k of either sign; the negative powers are rounded, hence the tolerance
+    /// </summary>
+    static bool is_pow10(long double x)
+    {
+        if (x <= 0)
+            return false;
+        const long double p = std::pow(10.0L, std::round(std::log10(x)));
+        return std::fabs(x - p) <= p * 1e-17L;
+    }
+
+    /// <summary>
+    /// Adds that multiply by b when it is 2 or 5, else 0: x2 is x + x, x5 is x2 + x2 + x
+    /// A decimal machine divides by one of them with the other and a shift: x / 2 = x5 / 10, x / 5 = x2 / 10
+    /// </summary>
+    static int small_factor(long double b)
+    {
+        b = std::fabs(b);
+        return b == 2 ? 1 : b == 5 ? 3 : 0;
+    }
+
+    friend Counted operator+(Counted a, Counted b)
+    {
+        op_counts.add++;
+        return a.v + b.v;
+    }
+    friend Counted operator-(Counted a, Counted b)
+    {
+        op_counts.add++;
+        return a.v - b.v;
+    }
+    friend Counted operator-(Counted a) { return -a.v; } // A sign flip
+    friend Counted operator*(Counted a, Counted b)
+    {
+        if (is_pow10(std::fabs(a.v)) || is_pow10(std::fabs(b.v)))
+            op_counts.shift++;
+        else if (int adds = small_factor(b.v) ? small_factor(b.v) : small_factor(a.v))
+            op_counts.add += adds;
+        else
+            op_counts.mul++;
+        return a.v * b.v;
+    }
+    friend Counted operator/(Counted a, Counted b)
+    {
+        if (is_pow10(std::fabs(b.v)))
+            op_counts.shift++;
+        else if (small_factor(b.v))
+        {
+            op_counts.add += small_factor(10 / b.v);
+            op_counts.shift++;
+        }
+        else
+            op_counts.div++;
+        return a.v / b.v;
+    }
+
+    friend bool operator==(Counted a, Counted b) { return op_counts.cmp++, a.v == b.v; }
+    friend bool operator!=(Counted a, Counted b) { return op_counts.cmp++, a.v != b.v; }
+    friend bool operator<(Counted a, Counted b) { return op_counts.cmp++, a.v < b.v; }
+    friend bool operator<=(Counted a, Counted b) { return op_counts.cmp++, a.v <= b.v; }
+    friend bool operator>(Counted a, Counted b) { return op_counts.cmp++, a.v > b.v; }
+    friend bool operator>=(Counted a, Counted b) { return op_counts.cmp++, a.v >= b.v; }
+};
+
+/// <summary>
+/// a x (1 + 10^-k) as the decimal types do it: one shift and one add
+/// </summary>
+inline Counted mul_1p10(const Counted &a, const Counted &, int k)
+{
+    op_counts.shift++;
+    op_counts.add++;
+    return a.v + a.v * std::pow(10.0L, -k);
+}
+
+/// <summary>
+/// Counted has the depth and Newton ceiling of the 16-digit decimal types; reading the exponent is free
+/// and scaling by 10^e is a shift
+/// </summary>
+template <>
+struct num_traits<Counted>
+{
+    using wide = long double;
+    static constexpr int radix = 10;
+    static constexpr int depth = 9;
+    static constexpr int newton = 6;
+
+    static Counted epsilon() { return 1e-15L; }
+    static Counted abs(Counted x) { return std::fabs(x.v); }
+    static bool isfinite(Counted x) { return std::isfinite(x.v); }
+    static bool isnan(Counted x) { return std::isnan(x.v); }
+    static bool signbit(Counted x) { return std::signbit(x.v); }
+    static Counted split(Counted x, int &e)
+    {
+        e = 0;
+        if (x.v == 0 || !std::isfinite(x.v))
+            return x;
+        e = int(std::floor(std::log10(std::fabs(x.v)))) + 1;
+        long double m = x.v / std::pow(10.0L, e);
+        if (std::fabs(m) >= 1) // log10 rounded across a power of ten
+        {
+            m = m / 10;
+            e++;
+        }
+        else if (std::fabs(m) < 0.1L)
+        {
+            m = m * 10;
+            e--;
+        }
+        return m;
+    }
+    static Counted scale(Counted x, int e)
+    {
+        op_counts.shift++;
+        return x.v * std::pow(10.0L, e);
+    }
+    static double to_double(Counted x) { return double(x.v); }
+};
+
+/// <summary>
+/// Cycles each kind of operation takes on the target, to turn operation counts into a latency estimate
+/// The defaults model a 16-digit decimal machine with a digit-serial adder: an add or a shift is a pass
+/// over the digits, a multiply or a divide one pass per digit of the multiplier or quotient
+/// </summary>
+struct CostModel
+{
+    double add = 16;
+    double mul = 16 * 16;
+    double div = 16 * 20;
+    double shift = 16;
+    double cmp = 16;
+    double khz = 1000; // Clock of the target
+
+    double cycles(const OpCounts &c) const
+    {
+        return add * c.add + mul * c.mul + div * c.div + shift * c.shift + cmp * c.cmp;
+    }
+
+    /// <summary>
+    /// Set one cost from "name=value", as given on the command line; false if it is not one of ours
+    /// </summary>
+    bool set(const char *arg)
+    {
+        const struct { const char *name; double *value; } fields[] = {
+            {"add", &add}, {"mul", &mul}, {"div", &div}, {"shift", &shift}, {"cmp", &cmp}, {"khz", &khz}};
+        const char *eq = std::strchr(arg, '=');
+        if (!eq)
+            return false;
+        for (const auto &f : fields)
+            if (std::strlen(f.name) == size_t(eq - arg) && std::strncmp(arg, f.name, eq - arg) == 0)
+            {
+                *f.value = std::atof(eq + 1);
+                return true;
+            }
+        return false;
+    }
+};
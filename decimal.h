@@ -0,0 +1,234 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "numtraits.h"
+
+#ifdef __SIZEOF_INT128__
+
+/// <summary>
+/// Decimal floating point number with 16 significant digits, as held by a calculator register
+/// value = (-1)^neg x coeff x 10^exp, coeff in [10^15, 10^16) unless the value is zero
+/// Every operation is rounded once to nearest, ties to even; exp is an int, so there is no
+/// overflow, and there are no NaN or infinities
+/// </summary>
+class Decimal
+{
+public:
+    static constexpr int digits = 16;
+    unsigned long long coeff = 0;
+    int exp = 0;
+    bool neg = false;
+
+    Decimal() = default;
+    Decimal(int v) { *this = round(v < 0, v < 0 ? -(long long)v : v, 0, false); }
+    Decimal(double v) : Decimal((long double)v) {}
+    Decimal(long double v)
+    {
+        if (v == 0 || !std::isfinite(v))
+            return;
+        // The C library does the correctly rounded binary to decimal conversion
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%.15Le", std::fabs(v));
+        for (const char *p = buf; *p != 'e'; p++)
+            if (*p != '.')
+                coeff = coeff * 10 + (*p - '0');
+        exp = std::atoi(std::strchr(buf, 'e') + 1) - (digits - 1);
+        neg = v < 0;
+    }
+    explicit operator long double() const
+    {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%s%llue%d", neg ? "-" : "", coeff, exp);
+        return std::strtold(buf, nullptr);
+    }
+    explicit operator double() const
+    {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%s%llue%d", neg ? "-" : "", coeff, exp);
+        return std::strtod(buf, nullptr);
+    }
+
+    static unsigned __int128 pow10(int k)
+    {
+        unsigned __int128 p = 1;
+        for (int i = 0; i < k; i++)
+            p *= 10;
+        return p;
+    }
+
+    /// <summary>
+    /// Round the exact result c x 10^e to 16 digits; sticky tells that nonzero digits were dropped below c
+    /// </summary>
+    static Decimal round(bool neg, unsigned __int128 c, int e, bool sticky)
+    {
+        Decimal r;
+        if (c == 0)
+            return r;
+
+        int nd = 0;
+        for (unsigned __int128 t = c; t; t /= 10)
+            nd++;
+
+        if (nd > digits)
+        {
+            const unsigned __int128 p = pow10(nd - digits);
+            const unsigned __int128 rem = c % p;
+            c = c / p;
+            e += nd - digits;
+            const unsigned __int128 half = p / 2;
+            if (rem > half || (rem == half && (sticky || (c & 1))))
+                c++;
+            if (c == pow10(digits))
+            {
+                c = pow10(digits - 1);
+                e++;
+            }
+        }
+        else if (nd < digits)
+        {
+            c = c * pow10(digits - nd);
+            e -= digits - nd;
+        }
+
+        r.coeff = (unsigned long long)c;
+        r.exp = e;
+        r.neg = neg;
+        return r;
+    }
+
+    friend Decimal operator+(Decimal a, Decimal b)
+    {
+        if (b.coeff == 0)
+            return a;
+        if (a.coeff == 0)
+            return b;
+        if (a.exp < b.exp)
+        {
+            const Decimal t = a;
+            a = b;
+            b = t;
+        }
+        // b is below 1/100 of a unit in the last place of a, it cannot move the rounded result
+        const int d = a.exp - b.exp;
+        if (d > digits + 1)
+            return a;
+
+        const unsigned __int128 ca = a.coeff * pow10(d);
+        const unsigned __int128 cb = b.coeff;
+        if (a.neg == b.neg)
+            return round(a.neg, ca + cb, b.exp, false);
+        if (ca >= cb)
+            return round(a.neg, ca - cb, b.exp, false);
+        return round(b.neg, cb - ca, b.exp, false);
+    }
+
+    friend Decimal operator-(Decimal a)
+    {
+        a.neg = !a.neg;
+        return a;
+    }
+
+    friend Decimal operator-(Decimal a, Decimal b) { return a + -b; }
+
+    friend Decimal operator*(Decimal a, Decimal b)
+    {
+        return round(a.neg != b.neg, (unsigned __int128)a.coeff * b.coeff, a.exp + b.exp, false);
+    }
+
+    friend Decimal operator/(Decimal a, Decimal b)
+    {
+        if (b.coeff == 0)
+            return Decimal(); // Error: Division by zero
+        // 17 digits or more in the quotient, the remainder is the sticky digit
+        const unsigned __int128 c = a.coeff * pow10(digits + 1);
+        return round(a.neg != b.neg, c / b.coeff, a.exp - b.exp - (digits + 1), c % b.coeff != 0);
+    }
+
+    static int compare(const Decimal &a, const Decimal &b)
+    {
+        const int sa = a.coeff == 0 ? 0 : a.neg ? -1 : 1;
+        const int sb = b.coeff == 0 ? 0 : b.neg ? -1 : 1;
+        if (sa != sb)
+            return sa < sb ? -1 : 1;
+        if (sa == 0)
+            return 0;
+        // Coefficients are normalized, so the exponent orders the magnitudes first
+        int m = 0;
+        if (a.exp != b.exp)
+            m = a.exp < b.exp ? -1 : 1;
+        else if (a.coeff != b.coeff)
+            m = a.coeff < b.coeff ? -1 : 1;
+        return sa * m;
+    }
+
+    friend bool operator==(const Decimal &a, const Decimal &b) { return compare(a, b) == 0; }
+    friend bool operator!=(const Decimal &a, const Decimal &b) { return compare(a, b) != 0; }
+    friend bool operator<(const Decimal &a, const Decimal &b) { return compare(a, b) < 0; }
+    friend bool operator<=(const Decimal &a, const Decimal &b) { return compare(a, b) <= 0; }
+    friend bool operator>(const Decimal &a, const Decimal &b) { return compare(a, b) > 0; }
+    friend bool operator>=(const Decimal &a, const Decimal &b) { return compare(a, b) >= 0; }
+};
+
+/// <summary>
+/// a x (1 + 10^-k) as a + a x 10^-k: the same exact value rounded once, without the multiplication
+/// </summary>
+inline Decimal mul_1p10(const Decimal &a, const Decimal &, int k)
+{
+    Decimal s = a;
+    s.exp -= k;
+    return a + s;
+}
+
+/// <summary>
+/// The exponent of a decimal value is already decimal: split() and scale() are exact and only touch exp
+/// </summary>
+template <>
+struct num_traits<Decimal>
+{
+    using wide = long double;
+    static constexpr int radix = 10;
+    static constexpr int depth = 9;
+    static constexpr int newton = 6;
+
+    static Decimal epsilon()
+    {
+        Decimal e;
+        e.coeff = 1000000000000000ULL;
+        e.exp = -30; // 10^15 x 10^-30
+        return e;
+    }
+    static Decimal abs(Decimal x)
+    {
+        x.neg = false;
+        return x;
+    }
+    static bool isfinite(const Decimal &) { return true; }
+    static bool isnan(const Decimal &) { return false; }
+    static bool signbit(const Decimal &x) { return x.neg; }
+    static Decimal split(Decimal x, int &e)
+    {
+        e = x.coeff ? x.exp + Decimal::digits : 0;
+        if (x.coeff)
+            x.exp = -Decimal::digits;
+        return x;
+    }
+    static Decimal scale(Decimal x, int e)
+    {
+        if (x.coeff)
+            x.exp += e;
+        return x;
+    }
+    static double to_double(const Decimal &x) { return (x.neg ? -1 : 1) * double(x.coeff) * std::pow(10.0, x.exp); }
+};
+
+#endif // __SIZEOF_INT128__
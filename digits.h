@@ -0,0 +1,155 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+/// <summary>
+/// Meggitt pseudo-division and pseudo-multiplication, shared by ln, exp, tan and atan
+/// Pseudo-division extracts Depth digits of the argument against a table of constants, one
+/// position at a time, and pseudo-multiplication rebuilds the result from LSB to MSB
+/// The operations on the data (the table and what a step does) are given by the caller, and so is the
+/// radix: the tables hold one constant per position and shift() moves the data from one position to the next
+/// LaneDigits below is the same engine over the lanes of a vector unit, for the batch kernels
+/// </summary>
+template <int Depth>
+struct Digits
+{
+    int d[Depth] = {0};
+
+    /// <summary>
+    /// Pseudo-division: at each position j, repeat step(j) while it succeeds and count how many times it did
+    /// step(j) returns false, leaving its data unchanged, when the step would overshoot
+    /// </summary>
+    template <typename Step>
+    void divide(Step step)
+    {
+        for (int j = 0; j < Depth; j++)
+            while (step(j))
+                d[j]++;
+    }
+
+    /// <summary>
+    /// Pseudo-multiplication: from LSB to the position last, apply step(j) d[j] times at each position,
+    /// followed by shift(j) which moves the data to the next position up (e.g. by the radix)
+    /// </summary>
+    template <typename Step, typename Shift>
+    void multiply(Step step, Shift shift, int last = 0) const
+    {
+        for (int j = Depth - 1; j >= last; j--)
+        {
+            for (int c = 0; c < d[j]; c++)
+                step(j);
+            shift(j);
+        }
+    }
+
+    /// <summary>
+    /// Steps of a divide() and a full multiply() over these digits: d[j] + 1 trials at each position,
+    /// then d[j] steps back
+    /// </summary>
+    int steps() const
+    {
+        int n = Depth;
+        for (int j = 0; j < Depth; j++)
+            n += 2 * d[j];
+        return n;
+    }
+
+    /// <summary>
+    /// Pseudo-multiplication where the digits simply weigh a table: result + sum of d[j] x weights[j]
+    /// Summed from LSB to MSB to maintain the precision
+    /// </summary>
+    template <typename T>
+    T sum(T result, const T *weights) const
+    {
+        for (int j = Depth - 1; j >= 0; j--)
+            result = result + d[j] * weights[j];
+        return result;
+    }
+};
+
+// The lane form is inlined into the batch kernels, which are compiled for their vector unit with target
+// attributes, so its vectors never cross a call and the ABI warning about them does not apply
+#if defined(__GNUC__) || defined(__clang__)
+#define LANES_INLINE inline __attribute__((always_inline))
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#else
+#define LANES_INLINE inline
+#endif
+
+/// <summary>
+/// Digits over the lanes of a vector unit, see Sse42Lanes in simd.h for the operations L gives
+/// Every lane keeps its own digit counts as doubles; each position runs under a mask until the last
+/// lane is done, so the lanes get the same digits, and the same results, as Digits one value at a time
+/// The steps are lambdas of the kernel, with its target attribute, that update their lanes of the data
+/// </summary>
+template <int Depth, typename L>
+struct LaneDigits
+{
+    using V = typename L::V;
+    using M = typename L::M;
+
+    V d[Depth];
+
+    /// <summary>
+    /// Pseudo-division: at each position j, step(j, active) tries one step and clears from active the
+    /// lanes where it would overshoot, committing it on the others, until no lane is active
+    /// </summary>
+    template <typename Step>
+    LANES_INLINE void divide(Step step)
+    {
+        for (int j = 0; j < Depth; j++)
+        {
+            d[j] = L::zero();
+            M active = L::all();
+            while (true)
+            {
+                step(j, active);
+                if (!L::any(active))
+                    break;
+                d[j] = L::inc(d[j], active);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Pseudo-multiplication: from LSB to the position last, step(j, active) on the lanes that still
+    /// have steps at position j, until none has, then shift(j) on all lanes
+    /// </summary>
+    template <typename Step, typename Shift>
+    LANES_INLINE void multiply(Step step, Shift shift, int last = 0) const
+    {
+        for (int j = Depth - 1; j >= last; j--)
+        {
+            V c = L::zero();
+            while (true)
+            {
+                const M active = L::below(c, d[j]);
+                if (!L::any(active))
+                    break;
+                step(j, active);
+                c = L::inc(c, L::all());
+            }
+            shift(j);
+        }
+    }
+
+    /// <summary>
+    /// Add the sum of d[j] x weights[j] to result in every lane, from LSB to MSB
+    /// result is updated in place, as a vector never crosses a call of this code
+    /// </summary>
+    LANES_INLINE void sum(V &result, const double *weights) const
+    {
+        for (int j = Depth - 1; j >= 0; j--)
+            result = L::add_mul(result, d[j], weights[j]);
+    }
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,130 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include "numtraits.h"
+
+/// <summary>
+/// Signed fixed point number with 31 integer and 32 fraction bits (Q31.32) in a 64-bit integer
+/// Products and quotients are rounded to nearest; there is no overflow detection
+/// </summary>
+class Fixed
+{
+public:
+    static constexpr int frac = 32; // Number of fraction bits
+    long long raw = 0;              // value x 2^frac
+
+    Fixed() = default;
+    Fixed(int v) : raw((long long)v * (1LL << frac)) {}
+    Fixed(double v) : raw(std::llround(std::ldexp(v, frac))) {}
+    Fixed(long double v) : raw(std::llround(std::ldexp(v, frac))) {}
+    explicit operator double() const { return std::ldexp(double(raw), -frac); }
+    explicit operator long double() const { return std::ldexp((long double)raw, -frac); }
+
+    static Fixed from_raw(long long r)
+    {
+        Fixed f;
+        f.raw = r;
+        return f;
+    }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return from_raw(a.raw + b.raw); }
+    friend Fixed operator-(Fixed a, Fixed b) { return from_raw(a.raw - b.raw); }
+    friend Fixed operator-(Fixed a) { return from_raw(-a.raw); }
+
+    friend Fixed operator*(Fixed a, Fixed b)
+    {
+        // (a x b) >> frac on the magnitudes, from four 32-bit partial products
+        const unsigned long long ua = a.raw < 0 ? -a.raw : a.raw;
+        const unsigned long long ub = b.raw < 0 ? -b.raw : b.raw;
+        const unsigned long long al = ua & 0xFFFFFFFF, ah = ua >> 32;
+        const unsigned long long bl = ub & 0xFFFFFFFF, bh = ub >> 32;
+        const unsigned long long ll = al * bl;
+        const unsigned long long mid = (ll >> 32) + (al * bh & 0xFFFFFFFF) + (ah * bl & 0xFFFFFFFF);
+        unsigned long long p = ah * bh + (al * bh >> 32) + (ah * bl >> 32) + (mid >> 32);
+        p = (p << 32) + (mid & 0xFFFFFFFF) + ((ll >> 31) & 1); // Round on the first dropped bit
+        return from_raw((a.raw < 0) != (b.raw < 0) ? -(long long)p : (long long)p);
+    }
+
+    friend Fixed operator/(Fixed a, Fixed b)
+    {
+        if (b.raw == 0)
+            return Fixed(); // Error: Division by zero
+        // (a << frac) / b on the magnitudes: the integer part, then one fraction bit at a time
+        const unsigned long long ua = a.raw < 0 ? -a.raw : a.raw;
+        const unsigned long long ub = b.raw < 0 ? -b.raw : b.raw;
+        unsigned long long q = ua / ub;
+        unsigned long long r = ua % ub;
+        for (int i = 0; i < frac; i++)
+        {
+            const bool carry = r >> 63;
+            r <<= 1;
+            q <<= 1;
+            if (carry || r >= ub)
+            {
+                r -= ub;
+                q |= 1;
+            }
+        }
+        if (r >= ub - r) // Round to nearest
+            q++;
+        return from_raw((a.raw < 0) != (b.raw < 0) ? -(long long)q : (long long)q);
+    }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+};
+
+/// <summary>
+/// A fixed point value has no exponent, split() and scale() shift the bits of the 64-bit word
+/// Precision is absolute, so epsilon is one unit of the last place of a value in [0.5, 1)
+/// </summary>
+template <>
+struct num_traits<Fixed>
+{
+    using wide = long double;
+    static constexpr int radix = 2;
+    static constexpr int depth = 6;
+    static constexpr int newton = 5;
+
+    static Fixed epsilon() { return Fixed::from_raw(2); }
+    static Fixed abs(Fixed x) { return x.raw < 0 ? -x : x; }
+    static bool isfinite(Fixed) { return true; }
+    static bool isnan(Fixed) { return false; }
+    static bool signbit(Fixed x) { return x.raw < 0; }
+    static Fixed split(Fixed x, int &e)
+    {
+        e = 0;
+        if (x.raw == 0)
+            return x;
+        const unsigned long long u = x.raw < 0 ? -x.raw : x.raw;
+        int msb = 0;
+        while (u >> (msb + 1))
+            msb++;
+        e = msb + 1 - Fixed::frac;
+        // Truncated so that the mantissa stays below 1
+        const unsigned long long m = msb < Fixed::frac ? u << (Fixed::frac - 1 - msb) : u >> (msb + 1 - Fixed::frac);
+        return Fixed::from_raw(x.raw < 0 ? -(long long)m : (long long)m);
+    }
+    static Fixed scale(Fixed x, int e)
+    {
+        const unsigned long long u = x.raw < 0 ? -x.raw : x.raw;
+        unsigned long long m;
+        if (e >= 0)
+            m = e < 64 ? u << e : 0;
+        else
+            m = -e < 64 ? (u + (1ULL << (-e - 1))) >> -e : 0; // Round to nearest
+        return Fixed::from_raw(x.raw < 0 ? -(long long)m : (long long)m);
+    }
+    static double to_double(Fixed x) { return double(x); }
+};
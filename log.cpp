@@ -5,12 +5,89 @@
     the Free Software Foundation, either version 3 of the License, or
     (at your option) any later version.
 */
-#include <iostream>
-#include <iomanip>
 #include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include "tables.h"
+#include "digits.h"
+#include "consts.h"
+#include "methods.h"
+#include "simd.h"
 
-// Use 6 to match examples from Jacques' web pages
-constexpr auto M = 7; // Log table size, affects precision of the result
+constexpr int KD = num_traits<double>::depth; // Digit positions of the double kernels, affects precision of the result
+
+/// <summary>
+/// 10^k for k >= 0 in the number type T, by squaring; exact while 10^k fits the precision of T
+/// </summary>
+template <typename T>
+static T pow10(int k)
+{
+    T result = 1;
+    T p = 10;
+    for (; k; k >>= 1)
+    {
+        if (k & 1)
+            result = result * p;
+        p = p * p;
+    }
+    return result;
+}
+
+/// <summary>
+/// Split a positive finite value into a decimal mantissa in [1,10) and exponent
+/// With normalized BCD-floating point format, this is really a simple read of the exponent;
+/// otherwise we estimate it from the exponent in the radix of T and scale once by a power of ten
+/// </summary>
+template <typename T>
+static T normalize10(T n, int &exp10)
+{
+    using nt = num_traits<T>;
+    static const double log10_radix = std::log10(double(nt::radix));
+
+    int exp;
+    nt::split(n, exp); // n = f x radix^exp, f in [1/radix,1)
+
+    // (exp-1) x log10(radix) <= log10(n), so the estimate is either exact or one too small
+    int e = int(floor((exp - 1) * log10_radix));
+    // A negative power is applied in two halves so that neither overflows for the smallest values
+    auto scale = [n](int k) { return k >= 0 ? n / pow10<T>(k) : n * pow10<T>(-k / 2) * pow10<T>(-k - -k / 2); };
+    T a = scale(e);
+    if (a >= 10)
+        a = scale(++e);
+
+    exp10 = e;
+    return a;
+}
+
+/// <summary>
+/// double takes its powers of ten from a table, all of them correctly rounded
+/// </summary>
+template <>
+double normalize10(double n, int &exp10)
+{
+    constexpr double log10_2 = 0.30102999566398120;
+
+    // Bring subnormals into the normal range first so the power of ten table suffices
+    int bias = 0;
+    if (n < 1e-290)
+    {
+        n = n * pow10_table[30];
+        bias = -30;
+    }
+
+    int exp2;
+    frexp(n, &exp2); // n = f x 2^exp2, f in [0.5,1)
+
+    // (exp2-1) x log10(2) <= log10(n), so the estimate is either exact or one too small
+    int e = int(floor((exp2 - 1) * log10_2));
+    auto scale = [n](int k) { return k >= 0 ? n / pow10_table[k] : n * pow10_table[-k]; };
+    double a = scale(e);
+    if (a >= 10.0)
+        a = scale(++e);
+
+    exp10 = e + bias;
+    return a;
+}
 
 /// <summary>
 /// Compute ln(x) or loge(x)
@@ -19,53 +96,249 @@ constexpr auto M = 7; // Log table size, affects precision of the result
 /// Domain: x > 0 (all positive real numbers)
 /// Range: All real numbers
 /// </summary>
-double ln1(const double n)
+template <typename T>
+T ln1(const T n)
 {
-    const double ln10 = log(10.0);
-    const double logs[] = {log(2.0), log(1.1), log(1.01), log(1.001), log(1.0001), log(1.00001), log(1.000001), log(1.0000001)};
-    const double table[] = {2, 1.1, 1.01, 1.001, 1.0001, 1.00001, 1.000001, 1.0000001};
+    using nt = num_traits<T>;
+    const Consts<T> &c = consts<T>();
+
+    // Tables start with the entry for the multiplier 2, ln(10) is the exponent step
+    const T *logs = c.logs + 1;
+    const T *table = c.mul + 1;
 
     if (n <= 0)
     {
         return 0; // Error: Invalid input value
     }
+    if (!nt::isfinite(n))
+        return n;
 
-    int digits[M] = {0};
-    double a = n;
+    Digits<nt::depth> digits;
 
-    // Suited to a BCD mantissa, we can calculate ln(mantissa) since its range is (0,10)
+    // Suited to a BCD mantissa, we can calculate ln(mantissa) since its range is [1,10)
     // Exponent contributes to ln(x) by this equality: ln(mant x 10^exp) = ln(mant) + exp x ln(10)
-    double kln10 = 0;
-    while (a >= 10.0) // With normalized BCD-floating point format, this loop is really a simple assignment of exponent to kln10 variable
+    int exp10;
+    T a = normalize10(n, exp10);
+    const T kln10 = exp10 * c.ln10;
+
+    digits.divide([&](int j) {
+        T p = mul_1p10(a, table[j], j); // With BCD, this is a fused add/shift: "a = a + (a >> j)" due to the nature of table[] values
+        if (p >= 10)
+            return false;
+        a = p;
+        return true;
+    });
+
+    T result = (10 - a) / 10;
+    result = digits.sum(result, logs);
+
+    result = c.ln10 - result;
+    result = result + kln10;
+
+    return result;
+}
+
+#if HAVE_X86_SIMD
+/// <summary>
+/// scale10_avx2() on 2 lanes, the powers loaded one by one
+/// </summary>
+TARGET_SSE42 static inline __m128d scale10_sse42(const __m128d n, const __m128d k)
+{
+    const __m128i idx = _mm_cvttpd_epi32(_mm_andnot_pd(_mm_set1_pd(-0.0), k));
+    const __m128d p = _mm_setr_pd(pow10_table.v[_mm_cvtsi128_si32(idx)], pow10_table.v[_mm_extract_epi32(idx, 1)]);
+    return _mm_blendv_pd(_mm_mul_pd(n, p), _mm_div_pd(n, p), _mm_cmpge_pd(k, _mm_setzero_pd()));
+}
+
+/// <summary>
+/// Scale n by 10^-k, the same way as normalize10() does: divide by a positive power, multiply by a negative one
+/// </summary>
+TARGET_AVX2 static inline __m256d scale10_avx2(const __m256d n, const __m256d k)
+{
+    const __m256d abs_k = _mm256_andnot_pd(_mm256_set1_pd(-0.0), k);
+    const __m256d p = _mm256_i32gather_pd(pow10_table.v, _mm256_cvttpd_epi32(abs_k), 8);
+    return _mm256_blendv_pd(_mm256_mul_pd(n, p), _mm256_div_pd(n, p), _mm256_cmp_pd(k, _mm256_setzero_pd(), _CMP_GE_OQ));
+}
+
+TARGET_AVX512 static inline __m512d scale10_avx512(const __m512d n, const __m512d k)
+{
+    const __m512d p = _mm512_i32gather_pd(_mm512_cvttpd_epi32(_mm512_abs_pd(k)), pow10_table.v, 8);
+    const __mmask8 k_pos = _mm512_cmp_pd_mask(k, _mm512_setzero_pd(), _CMP_GE_OQ);
+    return _mm512_mask_div_pd(_mm512_mul_pd(n, p), k_pos, n, p);
+}
+
+/// <summary>
+/// ln1() on 2 lanes at once, see ln1_avx2()
+/// </summary>
+TARGET_SSE42 static void ln1_sse42(const double *in, double *out, size_t count)
+{
+    const __m128d ten = _mm_set1_pd(10.0);
+    const __m128d one = _mm_set1_pd(1.0);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
     {
-        a = a / 10;
-        kln10 += ln10;
+        const __m128d n = _mm_loadu_pd(in + i);
+        const __m128d valid = _mm_and_pd(_mm_cmpge_pd(n, _mm_set1_pd(1e-290)), _mm_cmple_pd(n, _mm_set1_pd(DBL_MAX)));
+        if (_mm_movemask_pd(valid) != 0x3)
+        {
+            for (int j = 0; j < 2; j++)
+                out[i + j] = ln1(in[i + j]);
+            continue;
+        }
+
+        const __m128i e2 = _mm_srli_epi64(_mm_castpd_si128(n), 52);
+        const __m128d exp2_1 = _mm_sub_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(e2, _MM_SHUFFLE(2, 0, 2, 0))), _mm_set1_pd(1023));
+        __m128d e = _mm_floor_pd(_mm_mul_pd(exp2_1, _mm_set1_pd(0.30102999566398120)));
+        __m128d a = scale10_sse42(n, e);
+        const __m128d ge10 = _mm_cmpge_pd(a, ten);
+        if (_mm_movemask_pd(ge10))
+        {
+            e = _mm_add_pd(e, _mm_and_pd(ge10, one));
+            a = scale10_sse42(n, e);
+        }
+        const __m128d kln10 = _mm_mul_pd(e, _mm_set1_pd(ln10));
+
+        LaneDigits<KD, Sse42Lanes> digits;
+        digits.divide([&](int j, __m128d &active) TARGET_SSE42 {
+            const __m128d p = _mm_mul_pd(a, _mm_set1_pd(ln_mul[j + 1]));
+            active = _mm_and_pd(active, _mm_cmplt_pd(p, ten));
+            a = _mm_blendv_pd(a, p, active);
+        });
+
+        __m128d result = _mm_div_pd(_mm_sub_pd(ten, a), ten);
+        digits.sum(result, ln_logs + 1);
+
+        result = _mm_sub_pd(_mm_set1_pd(ln10), result);
+        _mm_storeu_pd(out + i, _mm_add_pd(result, kln10));
     }
 
-    for (int j = 0; j < M; j++)
+    for (; i < count; i++)
+        out[i] = ln1(in[i]);
+}
+
+/// <summary>
+/// ln1() on 4 lanes at once, with identical results: every lane keeps its own digit counters and
+/// each pseudo-division stage runs under a mask until the last lane has extracted its digit
+/// Vectors with a lane outside of [1e-290, DBL_MAX] go through the scalar code
+/// </summary>
+TARGET_AVX2 static void ln1_avx2(const double *in, double *out, size_t count)
+{
+    const __m256d ten = _mm256_set1_pd(10.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
     {
-        do
+        const __m256d n = _mm256_loadu_pd(in + i);
+        const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(n, _mm256_set1_pd(1e-290), _CMP_GE_OQ), _mm256_cmp_pd(n, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ));
+        if (_mm256_movemask_pd(valid) != 0xF)
         {
-            double p = a * table[j]; // With BCD, this is a fused add/shift: "a = a + (a >> 1)" due to the nature of table[] values
-            if (p >= 10.0)
-                break;
-            a = p;
-            digits[j]++;
-        } while (a < 10.0);
+            for (int j = 0; j < 4; j++)
+                out[i + j] = ln1(in[i + j]);
+            continue;
+        }
+
+        // normalize10(): decimal exponent estimated from the binary one, one scaling by a power of ten
+        const __m256i e2 = _mm256_srli_epi64(_mm256_castpd_si256(n), 52);
+        const __m128i e2_32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(e2, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+        const __m256d exp2_1 = _mm256_sub_pd(_mm256_cvtepi32_pd(e2_32), _mm256_set1_pd(1023)); // frexp() exponent - 1
+        __m256d e = _mm256_floor_pd(_mm256_mul_pd(exp2_1, _mm256_set1_pd(0.30102999566398120)));
+        __m256d a = scale10_avx2(n, e);
+        const __m256d ge10 = _mm256_cmp_pd(a, ten, _CMP_GE_OQ);
+        if (_mm256_movemask_pd(ge10))
+        {
+            e = _mm256_add_pd(e, _mm256_and_pd(ge10, one));
+            a = scale10_avx2(n, e);
+        }
+        const __m256d kln10 = _mm256_mul_pd(e, _mm256_set1_pd(ln10));
+
+        LaneDigits<KD, Avx2Lanes> digits;
+        digits.divide([&](int j, __m256d &active) TARGET_AVX2 {
+            const __m256d p = _mm256_mul_pd(a, _mm256_set1_pd(ln_mul[j + 1]));
+            active = _mm256_and_pd(active, _mm256_cmp_pd(p, ten, _CMP_LT_OQ));
+            a = _mm256_blendv_pd(a, p, active);
+        });
+
+        __m256d result = _mm256_div_pd(_mm256_sub_pd(ten, a), ten);
+        digits.sum(result, ln_logs + 1);
+
+        result = _mm256_sub_pd(_mm256_set1_pd(ln10), result);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(result, kln10));
     }
 
-    double result = (10.0 - a) / 10.0;
-    // From LSB to MSB to maintain the precision
-    for (int j = M - 1; j >= 0; j--)
-        result = result + digits[j] * logs[j];
+    for (; i < count; i++)
+        out[i] = ln1(in[i]);
+}
 
-    result = ln10 - result;
-    result += kln10;
+/// <summary>
+/// ln1() on 8 lanes at once, see ln1_avx2()
+/// </summary>
+TARGET_AVX512 static void ln1_avx512(const double *in, double *out, size_t count)
+{
+    const __m512d ten = _mm512_set1_pd(10.0);
+    const __m512d one = _mm512_set1_pd(1.0);
 
-    return result;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m512d n = _mm512_loadu_pd(in + i);
+        const __mmask8 valid = _mm512_cmp_pd_mask(n, _mm512_set1_pd(1e-290), _CMP_GE_OQ) & _mm512_cmp_pd_mask(n, _mm512_set1_pd(DBL_MAX), _CMP_LE_OQ);
+        if (valid != 0xFF)
+        {
+            for (int j = 0; j < 8; j++)
+                out[i + j] = ln1(in[i + j]);
+            continue;
+        }
+
+        const __m512i e2 = _mm512_srli_epi64(_mm512_castpd_si512(n), 52);
+        const __m512d exp2_1 = _mm512_sub_pd(_mm512_cvtepi64_pd(e2), _mm512_set1_pd(1023));
+        __m512d e = _mm512_roundscale_pd(_mm512_mul_pd(exp2_1, _mm512_set1_pd(0.30102999566398120)), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        __m512d a = scale10_avx512(n, e);
+        const __mmask8 ge10 = _mm512_cmp_pd_mask(a, ten, _CMP_GE_OQ);
+        if (ge10)
+        {
+            e = _mm512_mask_add_pd(e, ge10, e, one);
+            a = scale10_avx512(n, e);
+        }
+        const __m512d kln10 = _mm512_mul_pd(e, _mm512_set1_pd(ln10));
+
+        LaneDigits<KD, Avx512Lanes> digits;
+        digits.divide([&](int j, __mmask8 &active) TARGET_AVX512 {
+            const __m512d p = _mm512_mul_pd(a, _mm512_set1_pd(ln_mul[j + 1]));
+            active &= _mm512_cmp_pd_mask(p, ten, _CMP_LT_OQ);
+            a = _mm512_mask_mov_pd(a, active, p);
+        });
+
+        __m512d result = _mm512_div_pd(_mm512_sub_pd(ten, a), ten);
+        digits.sum(result, ln_logs + 1);
+
+        result = _mm512_sub_pd(_mm512_set1_pd(ln10), result);
+        _mm512_storeu_pd(out + i, _mm512_add_pd(result, kln10));
+    }
+
+    for (; i < count; i++)
+        out[i] = ln1(in[i]);
 }
+#endif // HAVE_X86_SIMD
 
-constexpr auto K = 7; // Log table size, affects precision of the result
+static void ln1_scalar(const double *in, double *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = ln1(in[i]);
+}
+
+/// <summary>
+/// Compute ln(x) of count values, with the kernel of the widest vector unit of the CPU
+/// </summary>
+void ln1_batch(const double *in, double *out, size_t count)
+{
+#if HAVE_X86_SIMD
+    static Dispatch dispatch(ln1_scalar, ln1_sse42, ln1_avx2, ln1_avx512);
+#else
+    static Dispatch dispatch(ln1_scalar);
+#endif
+    dispatch(in, out, count);
+}
 
 /// <summary>
 /// Compute exp(x)
@@ -74,11 +347,15 @@ constexpr auto K = 7; // Log table size, affects precision of the result
 /// Domain: All real numbers
 /// Range: x > 0 (all positive real numbers)
 /// </summary>
-double exp1(const double n)
+template <typename T>
+T exp1(const T n)
 {
-    const double ln10 = log(10.0);
-    const double logs[] = {ln10,log(2.0),log(1.1),log(1.01),log(1.001),log(1.0001),log(1.00001),log(1.000001),log(1.0000001),log(1.00000001)};
-    const double table[] = {0, 2, 1.1, 1.01, 1.001, 1.0001, 1.00001, 1.000001, 1.0000001, 1.00000001};
+    using nt = num_traits<T>;
+    constexpr int K = nt::depth;
+    const Consts<T> &c = consts<T>();
+
+    const T *logs = c.logs; // logs[0] is ln(10), digit 0 counts the decimal exponent
+    const T *table = c.mul;
 
     // XXX Handle extended input range, since log(9e+99) is arount 230, that is the maximum input value into this function
     //     In that case, the first loop below will count digit[0] to 99
@@ -86,77 +363,176 @@ double exp1(const double n)
     {
         return 0; // Error: Out of range
     }
+    if (n < -750)
+        return 0; // Underflow, below the smallest denormal; also keeps the digit[0] loop bounded
+    if (nt::isnan(n))
+        return n;
 
-    int digits[K + 1] = {0};
-    double a = fabs(n); // Compute using positive values only
+    Digits<K + 1> digits;
+    T a = nt::abs(n); // Compute using positive values only
     const bool is_neg = n < 0;
 
-    for (int j = 0; j < K + 1; j++)
-    {
-        do
-        {
-            double s = a - logs[j];
-            if (s < 0.0)
-                break;
-            a = s;
-            digits[j]++;
-        } while (a >= 0.0);
-    }
-    double result = a;
-    result = result * pow(10, K - 1); // Left align the result to form 0.x
+    digits.divide([&](int j) {
+        T s = a - logs[j];
+        if (s < 0)
+            return false;
+        a = s;
+        return true;
+    });
+    T result = a;
+    result = result * c.pow10[K - 1]; // Left align the result to form 0.x
 
-    // From LSB to MSB to maintain the precision
-    for (int j = K; j > 0; j--)
-    {
-        for (int c = 0; c < digits[j]; c++)
-        {
-            result = result * table[j] + 1;
-        }
-        result = result / 10;
-    }
+    // From LSB to MSB to maintain the precision; digit 0 is the decimal exponent
+    digits.multiply([&](int j) { result = mul_1p10(result, table[j], j - 1) + 1; },
+                    [&](int) { result = result / 10; }, 1);
 
-    result = result + 0.1;
+    result = result + T(1) / 10;
     result = result * 10;
-    for (int j = 0; j < digits[0]; j++)
+    for (int j = 0; j < digits.d[0]; j++)
         result = result * 10;
 
     if (is_neg)
-        result = 1.0 / result;
+        result = 1 / result;
 
     return result;
 }
 
-#define LN(x) ln1(x)
-#define EXP(x) exp1(x)
+#define INSTANTIATE(T) template T ln1<T>(const T); template T exp1<T>(const T);
+FOR_EACH_NUMBER_TYPE(INSTANTIATE)
+#undef INSTANTIATE
 
-void algo_log()
+#if HAVE_X86_SIMD
+/// <summary>
+/// exp1() on 4 lanes at once, with identical results: every lane keeps its own digit counters, the
+/// digit extraction and the reconstruction loops run under masks until the last lane is done
+/// Lanes above 230 or below -750 get the scalar error/underflow result, vectors with a NaN go through the scalar code
+/// </summary>
+TARGET_AVX2 static void exp1_avx2(const double *in, double *out, size_t count)
 {
-    const double tests_ln[] = {0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,1.234e34};
-    std::cout << "\n----- LN(x) -----\n";
-    for (int i = 0; i < sizeof(tests_ln) / sizeof(double); i++)
-    {
-        const double x = tests_ln[i];
-        const double verif = log(x);
-        const double result = LN(x);
-        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
-    }
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d ten = _mm256_set1_pd(10.0);
 
-    const double tests_exp[] = {0,-1,0.00000001,0.001,1.0,1.1,4.4,9.99,10,11,12.345,15.873,25.2332,87.2332,1.234e-13,9.999e-15,230};
-    std::cout << "\n----- EXP(x) -----\n";
-    for (int i = 0; i < sizeof(tests_exp) / sizeof(double); i++)
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
     {
-        const double x = tests_exp[i];
-        const double verif = exp(x);
-        const double result = EXP(x);
-        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+        const __m256d n = _mm256_loadu_pd(in + i);
+        if (_mm256_movemask_pd(_mm256_cmp_pd(n, n, _CMP_UNORD_Q)))
+        {
+            for (int j = 0; j < 4; j++)
+                out[i + j] = exp1(in[i + j]);
+            continue;
+        }
+        const __m256d in_range = _mm256_and_pd(_mm256_cmp_pd(n, _mm256_set1_pd(230), _CMP_LE_OQ), _mm256_cmp_pd(n, _mm256_set1_pd(-750), _CMP_GE_OQ));
+        const __m256d is_neg = _mm256_cmp_pd(n, zero, _CMP_LT_OQ);
+        __m256d a = _mm256_and_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), n), in_range); // Out of range lanes run with 0
+
+        LaneDigits<KD + 1, Avx2Lanes> digits;
+        digits.divide([&](int j, __m256d &active) TARGET_AVX2 {
+            const __m256d s = _mm256_sub_pd(a, _mm256_set1_pd(ln_logs[j]));
+            active = _mm256_and_pd(active, _mm256_cmp_pd(s, zero, _CMP_GE_OQ));
+            a = _mm256_blendv_pd(a, s, active);
+        });
+        __m256d result = _mm256_mul_pd(a, _mm256_set1_pd(pow10_table[KD - 1])); // Left align the result to form 0.x
+
+        // From LSB to MSB to maintain the precision; digit 0 is the decimal exponent
+        digits.multiply([&](int j, __m256d active) TARGET_AVX2 {
+            result = _mm256_blendv_pd(result, _mm256_add_pd(_mm256_mul_pd(result, _mm256_set1_pd(ln_mul[j])), one), active);
+        }, [&](int) TARGET_AVX2 { result = _mm256_div_pd(result, ten); }, 1);
+
+        result = _mm256_add_pd(result, _mm256_set1_pd(0.1));
+        result = _mm256_mul_pd(result, ten);
+        __m256d c = zero;
+        while (true)
+        {
+            const __m256d active = _mm256_cmp_pd(c, digits.d[0], _CMP_LT_OQ);
+            if (_mm256_movemask_pd(active) == 0)
+                break;
+            result = _mm256_blendv_pd(result, _mm256_mul_pd(result, ten), active);
+            c = _mm256_add_pd(c, one);
+        }
+
+        result = _mm256_blendv_pd(result, _mm256_div_pd(one, result), is_neg);
+        _mm256_storeu_pd(out + i, _mm256_and_pd(result, in_range));
     }
 
-    std::cout << "\n----- LN(x)/EXP(x) SYMMETRY -----\n";
-    for (int i = 0; i < sizeof(tests_ln) / sizeof(double); i++)
+    for (; i < count; i++)
+        out[i] = exp1(in[i]);
+}
+
+/// <summary>
+/// exp1() on 8 lanes at once, see exp1_avx2()
+/// </summary>
+TARGET_AVX512 static void exp1_avx512(const double *in, double *out, size_t count)
+{
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d ten = _mm512_set1_pd(10.0);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
     {
-        const double x = tests_ln[i];
-        const double verif = exp(log(x));
-        const double result = EXP(LN(x));
-        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+        const __m512d n = _mm512_loadu_pd(in + i);
+        if (_mm512_cmp_pd_mask(n, n, _CMP_UNORD_Q))
+        {
+            for (int j = 0; j < 8; j++)
+                out[i + j] = exp1(in[i + j]);
+            continue;
+        }
+        const __mmask8 in_range = _mm512_cmp_pd_mask(n, _mm512_set1_pd(230), _CMP_LE_OQ) & _mm512_cmp_pd_mask(n, _mm512_set1_pd(-750), _CMP_GE_OQ);
+        const __mmask8 is_neg = _mm512_cmp_pd_mask(n, zero, _CMP_LT_OQ);
+        __m512d a = _mm512_mask_abs_pd(zero, in_range, n); // Out of range lanes run with 0
+
+        LaneDigits<KD + 1, Avx512Lanes> digits;
+        digits.divide([&](int j, __mmask8 &active) TARGET_AVX512 {
+            const __m512d s = _mm512_sub_pd(a, _mm512_set1_pd(ln_logs[j]));
+            active &= _mm512_cmp_pd_mask(s, zero, _CMP_GE_OQ);
+            a = _mm512_mask_mov_pd(a, active, s);
+        });
+        __m512d result = _mm512_mul_pd(a, _mm512_set1_pd(pow10_table[KD - 1])); // Left align the result to form 0.x
+
+        // From LSB to MSB to maintain the precision; digit 0 is the decimal exponent
+        digits.multiply([&](int j, __mmask8 active) TARGET_AVX512 {
+            result = _mm512_mask_add_pd(result, active, _mm512_mul_pd(result, _mm512_set1_pd(ln_mul[j])), one);
+        }, [&](int) TARGET_AVX512 { result = _mm512_div_pd(result, ten); }, 1);
+
+        result = _mm512_add_pd(result, _mm512_set1_pd(0.1));
+        result = _mm512_mul_pd(result, ten);
+        __m512d c = zero;
+        while (true)
+        {
+            const __mmask8 active = _mm512_cmp_pd_mask(c, digits.d[0], _CMP_LT_OQ);
+            if (!active)
+                break;
+            result = _mm512_mask_mul_pd(result, active, result, ten);
+            c = _mm512_add_pd(c, one);
+        }
+
+        result = _mm512_mask_div_pd(result, is_neg, one, result);
+        _mm512_storeu_pd(out + i, _mm512_maskz_mov_pd(in_range, result));
     }
+
+    for (; i < count; i++)
+        out[i] = exp1(in[i]);
+}
+#endif // HAVE_X86_SIMD
+
+static void exp1_scalar(const double *in, double *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = exp1(in[i]);
+}
+
+/// <summary>
+/// Compute exp(x) of count values, with the kernel of the widest vector unit of the CPU
+/// </summary>
+void exp1_batch(const double *in, double *out, size_t count)
+{
+#if HAVE_X86_SIMD
+    // Two lanes gain less on the data-dependent loops of exp1() than they lose to the masking, so sse4.2 runs the scalar code
+    static Dispatch dispatch(exp1_scalar, nullptr, exp1_avx2, exp1_avx512);
+#else
+    static Dispatch dispatch(exp1_scalar);
+#endif
+    dispatch(in, out, count);
 }
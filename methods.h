@@ -0,0 +1,34 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include "numtraits.h"
+
+// The numerical methods over a number type T, instantiated for every type of FOR_EACH_NUMBER_TYPE
+template <typename T> T sqrt1(const T n);
+template <typename T> T ln1(const T n);
+template <typename T> T exp1(const T n);
+template <typename T> int reduce_pio2(const T n, T &r);
+template <typename T> T range_reduction(T n);
+template <typename T> T tan1(const T n);
+template <typename T> int tan1_steps(const T n);
+template <typename T> void sincos1(const T n, T &s, T &c);
+template <typename T> T atan1(const T n);
+template <typename T> T atan2_1(const T y, const T x);
+template <typename T> void polar1(const T x, const T y, T &r, T &theta);
+
+// double reduces any finite angle exactly
+template <> int reduce_pio2<double>(const double n, double &r);
+
+// Batch versions over double, each dispatched on its first call to the kernel of the widest vector unit of the CPU, see Dispatch in simd.h
+void sqrt1_batch(const double *in, double *out, size_t count);
+void ln1_batch(const double *in, double *out, size_t count);
+void exp1_batch(const double *in, double *out, size_t count);
+void tan1_batch(const double *in, double *out, size_t count);
+void atan1_batch(const double *in, double *out, size_t count);
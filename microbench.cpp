@@ -0,0 +1,475 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <string_view>
+#include <random>
+#include <string>
+#include <algorithm>
+#include "microbench.h"
+#include "registry.h"
+#include "simd.h"
+#include "perf.h"
+#include "methods.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Microbenchmark suite: every implementation of every function in the registry, in latency and throughput
+// modes, with the mean and the 95% confidence interval of repeated trials and the speedup against libm
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/// <summary>
+/// Mean of the trials and the half width of its 95% confidence interval, from Student's t
+/// </summary>
+struct Estimate
+{
+    double mean = 0;
+    double ci = 0;
+};
+
+Estimate estimate(const std::vector<double> &x)
+{
+    static const double t95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    const size_t n = x.size();
+    Estimate e;
+    for (double v : x)
+        e.mean += v;
+    e.mean /= n;
+    double var = 0;
+    for (double v : x)
+        var += (v - e.mean) * (v - e.mean);
+    var /= n - 1;
+    const size_t df = n - 1;
+    const double t = df <= 30 ? t95[df - 1] : df <= 60 ? 2.000 : df <= 120 ? 1.980 : 1.960;
+    e.ci = t * std::sqrt(var / n);
+    return e;
+}
+
+/// <summary>
+/// Pin the thread to one CPU, so that all trials run on the same core and its caches; returns the CPU or -1
+/// </summary>
+int pin(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0)
+        cpu = sched_getcpu();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (cpu >= 0 && sched_setaffinity(0, sizeof(set), &set) == 0)
+        return cpu;
+#endif
+    (void)cpu;
+    return -1;
+}
+
+volatile double sink; // Keeps the results of the timed loops alive
+
+/// <summary>
+/// Each input waits for the previous result: y * 0 adds the dependency without changing the input,
+/// and costs the same multiply-add in every implementation
+/// </summary>
+double latency_run(ScalarFn f, const std::vector<double> &in, int reps)
+{
+    double y = 0;
+    const auto start = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (double x : in)
+            y = f(x + y * 0.0);
+    const auto stop = Clock::now();
+    sink = y;
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+double throughput_run(ScalarFn f, const std::vector<double> &in, std::vector<double> &out, int reps)
+{
+    const size_t n = in.size();
+    const auto start = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (size_t i = 0; i < n; i++)
+            out[i] = f(in[i]);
+    const auto stop = Clock::now();
+    sink = out[reps % n];
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+double array_run(BatchFn f, const std::vector<double> &in, std::vector<double> &out, int reps)
+{
+    const auto start = Clock::now();
+    for (int r = 0; r < reps; r++)
+        f(in.data(), out.data(), in.size());
+    const auto stop = Clock::now();
+    sink = out[reps % in.size()];
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+/// <summary>
+/// ns per element of run(reps) over count elements: the repetitions are doubled until one trial
+/// lasts trial_ms, which also warms up the code path, then the trials are timed
+/// </summary>
+template <typename Run>
+int calibrate(Run run, const BenchOptions &opt)
+{
+    int reps = 1;
+    while (run(reps) < opt.trial_ms * 1e6 && reps < (1 << 24))
+        reps *= 2;
+    return reps;
+}
+
+template <typename Run>
+Estimate measure(Run run, size_t count, const BenchOptions &opt)
+{
+    const int reps = calibrate(run, opt);
+    std::vector<double> trials(opt.trials);
+    for (auto &t : trials)
+        t = run(reps) / (double(reps) * count);
+    return estimate(trials);
+}
+
+/// <summary>
+/// Spin until the clock of the core has ramped up
+/// </summary>
+void warmup(const BenchOptions &opt)
+{
+    const auto in = Registry::inputs(Fn::sqrt, 1024);
+    const auto until = Clock::now() + std::chrono::duration<double, std::milli>(opt.warmup_ms);
+    while (Clock::now() < until)
+        latency_run(Registry::get().selected_one(Fn::sqrt).one, in, 1);
+}
+
+void print_pinning(int cpu)
+{
+    if (cpu >= 0)
+        std::cout << "pinned to CPU " << cpu;
+    else
+        std::cout << "not pinned";
+}
+
+struct Row
+{
+    const char *impl;
+    const char *mode;
+    Estimate ns;
+};
+
+void print_row(const char *fn, const Row &row, double libm_ns)
+{
+    std::cout << std::left << std::setw(10) << fn << std::setw(8) << row.impl << std::setw(12) << row.mode << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10) << row.ns.mean << std::setw(9) << row.ns.ci
+              << std::setw(9) << libm_ns / row.ns.mean << "x\n";
+}
+} // namespace
+
+/// <summary>
+/// Time every implementation of every function over the inputs of the registry and print one row per
+/// implementation and mode; "vs libm" is the speedup over libm in the same mode, above 1 when faster
+/// </summary>
+void microbench(const BenchOptions &opt)
+{
+    const size_t count = 1024; // In L1 with its results
+    const int cpu = pin(opt.cpu);
+
+    warmup(opt);
+
+    std::cout << "\n----- Microbenchmark: ns per call, mean and 95% confidence over " << opt.trials << " trials, ";
+    print_pinning(cpu);
+    std::cout << ", batch kernels " << isa_name(Dispatch::level()) << " -----\n";
+    std::cout << "function  impl    mode           ns/call  ci 95%  vs libm\n";
+
+    for (int f = 0; f < int(Fn::count); f++)
+    {
+        const auto in = Registry::inputs(Fn(f), count);
+        std::vector<double> out(count);
+        size_t n;
+        const Impl *impls = Registry::get().impls(Fn(f), n);
+
+        std::vector<Row> rows;
+        double libm_latency = 0, libm_throughput = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const Impl &impl = impls[i];
+            const bool libm = std::string_view(impl.name) == "libm";
+            if (opt.latency && impl.one)
+            {
+                rows.push_back({impl.name, "latency", measure([&](int reps) { return latency_run(impl.one, in, reps); }, count, opt)});
+                if (libm)
+                    libm_latency = rows.back().ns.mean;
+            }
+            if (opt.throughput && impl.one)
+            {
+                rows.push_back({impl.name, "throughput", measure([&](int reps) { return throughput_run(impl.one, in, out, reps); }, count, opt)});
+                if (libm)
+                    libm_throughput = rows.back().ns.mean;
+            }
+            if (opt.throughput && impl.batch && !impl.one)
+                rows.push_back({impl.name, "array", measure([&](int reps) { return array_run(impl.batch, in, out, reps); }, count, opt)});
+        }
+        for (const Row &row : rows)
+            print_row(Registry::name(Fn(f)), row, row.mode[0] == 'l' ? libm_latency : libm_throughput);
+    }
+}
+
+namespace
+{
+/// <summary>
+/// Inputs of one class: 10^[lo, hi) for a log-uniform range, else [lo, hi)
+/// </summary>
+struct InputClass
+{
+    const char *name;
+    double lo, hi;
+    bool log_uniform;
+
+    std::vector<double> inputs(size_t count) const
+    {
+        std::mt19937_64 gen(1);
+        std::uniform_real_distribution<double> dist(lo, hi);
+        std::vector<double> in(count);
+        for (auto &x : in)
+            x = log_uniform ? std::pow(10, dist(gen)) : dist(gen);
+        return in;
+    }
+};
+
+// Per function: the short path, the inputs of the registry, and a wide range that exercises the reductions
+const InputClass input_classes[int(Fn::count)][3] = {
+    {{"[0.25,1)", 0.25, 1, false}, {"1e[-2,3)", -2, 3, true}, {"1e[-300,300)", -300, 300, true}},
+    {{"[0.9,1.1)", 0.9, 1.1, false}, {"1e[-2,3)", -2, 3, true}, {"1e[-300,300)", -300, 300, true}},
+    {{"[-1,1)", -1, 1, false}, {"[-10,10)", -10, 10, false}, {"[-230,230)", -230, 230, false}},
+    {{"[-pi/4,pi/4)", -0.7853981633974483, 0.7853981633974483, false}, {"[-1.5,1.5)", -1.5, 1.5, false}, {"[-1e6,1e6)", -1e6, 1e6, false}},
+    {{"[-1,1)", -1, 1, false}, {"[-100,100)", -100, 100, false}, {"1e[10,300)", 10, 300, true}},
+};
+
+/// <summary>
+/// Time one calibrated run with the counters on, and print the counts per call
+/// </summary>
+template <typename Run>
+void print_counter_row(const char *fn, const char *cls, const char *impl, Run run, size_t count, const BenchOptions &opt, PerfCounters &pc)
+{
+    const int reps = calibrate(run, opt);
+    pc.start();
+    const double ns = run(reps);
+    pc.stop();
+    const double calls = double(reps) * count;
+
+    std::cout << std::left << std::setw(8) << fn << " " << std::setw(14) << cls << std::setw(8) << impl << std::right
+              << std::fixed << std::setprecision(1) << std::setw(8) << ns / calls;
+    if (!pc.available())
+    {
+        std::cout << "\n";
+        return;
+    }
+    for (int e = 0; e < PerfCounters::events; e++)
+    {
+        const auto ev = PerfCounters::Event(e);
+        std::cout << std::setw(14);
+        if (pc.has(ev))
+            std::cout << std::setprecision(e < PerfCounters::branch_misses ? 1 : 3) << pc.value(ev) / calls;
+        else
+            std::cout << "-";
+    }
+    if (pc.has(PerfCounters::cycles) && pc.has(PerfCounters::instructions) && pc.value(PerfCounters::cycles) > 0)
+        std::cout << std::setprecision(2) << std::setw(7) << pc.value(PerfCounters::instructions) / pc.value(PerfCounters::cycles);
+    std::cout << "\n";
+}
+} // namespace
+
+/// <summary>
+/// Hardware counters per call of every implementation of every function, for each input class, so that
+/// the time of the digit loops can be told apart: instructions for the loop counts, branch misses for
+/// data-dependent exits, cache misses for the tables. Without counters only the time is printed
+/// </summary>
+void counter_bench(const BenchOptions &opt)
+{
+    const size_t count = 1024;
+    const int cpu = pin(opt.cpu);
+    PerfCounters pc;
+    warmup(opt);
+
+    std::cout << "\n----- Hardware counters per call, by input class, ";
+    print_pinning(cpu);
+    std::cout << " -----\n";
+    if (!pc.available())
+        std::cout << "Counters unavailable (" << pc.why() << "), time only\n";
+    std::cout << std::left << std::setw(8) << "function" << std::setw(15) << " class" << std::setw(8) << "impl" << std::right << std::setw(8) << "ns";
+    if (pc.available())
+    {
+        for (int e = 0; e < PerfCounters::events; e++)
+            std::cout << std::setw(14) << PerfCounters::name(PerfCounters::Event(e));
+        std::cout << std::setw(7) << "IPC";
+    }
+    std::cout << "\n";
+
+    for (int f = 0; f < int(Fn::count); f++)
+    {
+        size_t n;
+        const Impl *impls = Registry::get().impls(Fn(f), n);
+        for (const InputClass &cls : input_classes[f])
+        {
+            const auto in = cls.inputs(count);
+            std::vector<double> out(count);
+            for (size_t i = 0; i < n; i++)
+            {
+                const Impl &impl = impls[i];
+                if (impl.one)
+                    print_counter_row(Registry::name(Fn(f)), cls.name, impl.name, [&](int reps) { return throughput_run(impl.one, in, out, reps); }, count, opt, pc);
+                else
+                    print_counter_row(Registry::name(Fn(f)), cls.name, impl.name, [&](int reps) { return array_run(impl.batch, in, out, reps); }, count, opt, pc);
+            }
+        }
+    }
+}
+
+namespace
+{
+/// <summary>
+/// Decimal exponent buckets of one function: [10^e, 10^(e+width)) for e from lo to hi in steps of
+/// width, of either sign if signed, capped at max where the function overflows
+/// A function can have several sets, so that it is timed a decade at a time where its cost follows the
+/// exponent and in coarse buckets out in the far exponents
+/// </summary>
+struct Buckets
+{
+    const char *name;
+    ScalarFn f;
+    int lo, hi, width;
+    bool signed_inputs;
+    double max;
+};
+
+double tan1_d(double x) { return tan1(x); }
+
+const Buckets bucket_sets[] = {
+    {"sqrt1", sqrt1<double>, -300, -60, 40, false, 1e308},
+    {"sqrt1", sqrt1<double>, -20, 19, 1, false, 1e308},
+    {"sqrt1", sqrt1<double>, 20, 260, 40, false, 1e308},
+    {"ln1", ln1<double>, -300, -60, 40, false, 1e308},
+    {"ln1", ln1<double>, -20, 19, 1, false, 1e308},
+    {"ln1", ln1<double>, 20, 260, 40, false, 1e308},
+    {"exp1", exp1<double>, -4, 2, 1, true, 230},
+    {"tan1", tan1_d, -4, 20, 2, true, 1e308},
+    {"range_reduction", range_reduction<double>, -4, 20, 2, true, 1e308},
+    {"atan1", atan1<double>, -12, 12, 3, true, 1e308},
+};
+
+/// <summary>
+/// Timestamp for timing one call: the TSC between fences on x86, so that the call neither starts before
+/// the first read nor is still running at the second; elsewhere the steady clock in ns
+/// </summary>
+#if HAVE_X86_SIMD
+inline uint64_t ticks()
+{
+    _mm_lfence();
+    const uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+/// <summary>
+/// ns per tick, against the steady clock over 20 ms
+/// </summary>
+double ns_per_tick()
+{
+    const auto t0 = Clock::now();
+    const uint64_t k0 = ticks();
+    while (Clock::now() - t0 < std::chrono::milliseconds(20))
+        ;
+    const uint64_t k1 = ticks();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / double(k1 - k0);
+}
+#else
+inline uint64_t ticks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+double ns_per_tick() { return 1; }
+#endif
+
+/// <summary>
+/// count inputs of 10^[lo, hi) from the bucket, of either sign if it is signed
+/// </summary>
+std::vector<double> bucket_inputs(const Buckets &b, double lo, double hi, size_t count, std::mt19937_64 &gen)
+{
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> in(count);
+    for (auto &x : in)
+    {
+        x = std::pow(10, dist(gen));
+        if (b.signed_inputs && (gen() & 1))
+            x = -x;
+    }
+    return in;
+}
+} // namespace
+
+/// <summary>
+/// Latency distribution by the decimal exponent of the input: for each bucket, times single calls on
+/// inputs spread log-uniformly over it and prints the p50, p99 and max of the time per call
+/// Each timed input is new to the branch predictors: the code and the tables are warmed up by a pass
+/// over other inputs of the bucket, so the data-dependent mispredicts of the digit loops show in the tail
+/// The median cost of reading the timestamp is taken out of every sample
+/// </summary>
+void latency_distribution(const BenchOptions &opt)
+{
+    const int cpu = pin(opt.cpu);
+    warmup(opt);
+
+    std::vector<double> overhead(1000);
+    for (auto &o : overhead)
+    {
+        const uint64_t start = ticks();
+        o = double(ticks() - start);
+    }
+    std::sort(overhead.begin(), overhead.end());
+    const double timer_ticks = overhead[overhead.size() / 2];
+    const double tick_ns = ns_per_tick();
+
+    std::cout << "\n----- Latency by decimal exponent of the input, ns per call over " << opt.samples << " inputs per bucket, ";
+    print_pinning(cpu);
+    std::cout << " -----\n";
+    std::cout << "function         |x| in                   p50       p99       max\n";
+
+    std::mt19937_64 gen(1);
+    std::vector<double> samples(opt.samples);
+    for (const Buckets &b : bucket_sets)
+        for (int e = b.lo; e <= b.hi; e += b.width)
+        {
+            const double top = std::min(double(e + b.width), std::log10(b.max));
+            if (top <= e)
+                break;
+            for (double x : bucket_inputs(b, e, top, samples.size(), gen))
+                sink = b.f(x);
+
+            const auto in = bucket_inputs(b, e, top, samples.size(), gen);
+            for (size_t i = 0; i < in.size(); i++)
+            {
+                const uint64_t start = ticks();
+                const double y = b.f(in[i]);
+                const uint64_t stop = ticks();
+                sink = y;
+                samples[i] = std::max(0.0, double(stop - start) - timer_ticks) * tick_ns;
+            }
+            std::sort(samples.begin(), samples.end());
+
+            const std::string range = "1e" + std::to_string(e) + " .. " + (top < e + b.width ? std::to_string(int(b.max)) : "1e" + std::to_string(e + b.width));
+            std::cout << std::left << std::setw(17) << b.name << std::setw(20) << range << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << samples[samples.size() / 2] << std::setw(10) << samples[samples.size() * 99 / 100]
+                      << std::setw(10) << samples.back() << "\n";
+        }
+}
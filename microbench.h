@@ -0,0 +1,60 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+
+/// <summary>
+/// Settings of the microbenchmark suite, from "name=value" arguments or a mode name on the command line
+/// </summary>
+struct BenchOptions
+{
+    bool latency = true;     // Dependent chain of calls: each input waits for the previous result
+    bool throughput = true;  // Independent calls over an array
+    int trials = 20;         // Timed trials per measurement, for the mean and its confidence interval
+    int cpu = -1;            // CPU to pin the thread to; -1 for the one it starts on
+    double warmup_ms = 100;  // Untimed run before the first measurement, for the clock and the caches
+    double trial_ms = 10;    // Least duration of one trial
+    int samples = 1000;      // Inputs per bucket of the latency distribution
+
+    /// <summary>
+    /// Set one option from "latency", "throughput" or "name=value"; false if it is not one of ours
+    /// </summary>
+    bool set(const char *arg)
+    {
+        if (std::strcmp(arg, "latency") == 0 || std::strcmp(arg, "throughput") == 0)
+        {
+            latency = arg[0] == 'l';
+            throughput = !latency;
+            return true;
+        }
+        const char *eq = std::strchr(arg, '=');
+        if (!eq)
+            return false;
+        const std::size_t len = eq - arg;
+        const double value = std::atof(eq + 1);
+        if (len == 6 && std::strncmp(arg, "trials", len) == 0)
+            trials = value < 2 ? 2 : int(value);
+        else if (len == 3 && std::strncmp(arg, "cpu", len) == 0)
+            cpu = int(value);
+        else if (len == 6 && std::strncmp(arg, "warmup", len) == 0)
+            warmup_ms = value;
+        else if (len == 5 && std::strncmp(arg, "trial", len) == 0)
+            trial_ms = value;
+        else if (len == 7 && std::strncmp(arg, "samples", len) == 0)
+            samples = value < 1 ? 1 : int(value);
+        else
+            return false;
+        return true;
+    }
+};
+
+void microbench(const BenchOptions &opt);
+void counter_bench(const BenchOptions &opt);
+void latency_distribution(const BenchOptions &opt);
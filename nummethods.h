@@ -0,0 +1,56 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#ifndef NUMMETHODS_H
+#define NUMMETHODS_H
+
+/*
+ * C interface of libnummethods: the methods over double, as built by "make lib"
+ *
+ * The ABI is stable within an NM_ABI_VERSION: functions are only added, never changed or removed.
+ * A program can compare nm_abi_version() with the NM_ABI_VERSION it was compiled with.
+ *
+ * The array functions compute out[i * out_stride] = f(in[i * in_stride]) for i in [0, count).
+ * Strides are in elements and may be negative; in and out may be the same array with the same stride.
+ * Unit strides go straight to the vector kernels, other strides through a small buffer.
+ */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(NUMMETHODS_DLL)
+#define NM_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define NM_API __attribute__((visibility("default")))
+#else
+#define NM_API
+#endif
+
+#define NM_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+NM_API int nm_abi_version(void);
+
+NM_API double nm_sqrt(double x);
+NM_API double nm_ln(double x);
+NM_API double nm_exp(double x);
+NM_API double nm_tan(double x);
+NM_API double nm_atan(double x);
+
+NM_API void nm_sqrt_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count);
+NM_API void nm_ln_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count);
+NM_API void nm_exp_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count);
+NM_API void nm_tan_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count);
+NM_API void nm_atan_array(const double *in, ptrdiff_t in_stride, double *out, ptrdiff_t out_stride, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NUMMETHODS_H */
@@ -0,0 +1,162 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/// <summary>
+/// Number type interface of the numerical methods
+/// The algorithms only use + - * / and comparisons on a number type T, with conversions from int
+/// and floating point constants; everything else they need from T is given by a specialization:
+///
+///   wide      Type the constant tables of T are generated in, at least as precise as T
+///   radix     Radix of the exponent, 2 for binary types and 10 for decimal ones
+///   depth     Number of digit positions of the pseudo-division and pseudo-multiplication
+///   newton    Ceiling on the Newton iterations of sqrt
+///   epsilon   Relative precision
+///   abs, isfinite, isnan, signbit
+///   split     x = m x radix^e, m in [1/radix, 1)
+///   scale     x x radix^e
+///   to_double Nearest double, for the initial estimates only
+/// </summary>
+template <typename T>
+struct num_traits;
+
+/// <summary>
+/// Traits of the built-in binary floating point types
+/// Depth follows from the precision: after depth digits the remainder r is below 10^-(depth-1) and
+/// the error of its first order term, r^2/2, has to stay under epsilon
+/// Newton starts from a 7-bit seed and doubles the good bits at each step, plus one step to confirm
+/// </summary>
+template <typename T, typename W, int Depth, int Newton>
+struct binary_traits
+{
+    using wide = W;
+    static constexpr int radix = 2;
+    static constexpr int depth = Depth;
+    static constexpr int newton = Newton;
+
+    static T epsilon() { return std::numeric_limits<T>::epsilon(); }
+    static T abs(T x) { return std::fabs(x); }
+    static bool isfinite(T x) { return std::isfinite(x); }
+    static bool isnan(T x) { return std::isnan(x); }
+    static bool signbit(T x) { return std::signbit(x); }
+    static T split(T x, int &e) { return std::frexp(x, &e); }
+    static T scale(T x, int e) { return std::ldexp(x, e); }
+    static double to_double(T x) { return double(x); }
+};
+
+#ifdef __SIZEOF_FLOAT128__
+using wide_float = __float128;
+#else
+using wide_float = long double;
+#endif
+
+template <> struct num_traits<float> : binary_traits<float, long double, 5, 4> {};
+template <> struct num_traits<double> : binary_traits<double, long double, 7, 5> {};
+template <> struct num_traits<long double> : binary_traits<long double, wide_float, 11, 6> {};
+
+#ifdef __SIZEOF_FLOAT128__
+/// <summary>
+/// IEEE binary128 in software, the functions of <cmath> do not take it so the exponent is handled on the bits
+/// </summary>
+template <>
+struct num_traits<__float128>
+{
+    using wide = __float128;
+    static constexpr int radix = 2;
+    static constexpr int depth = 19;
+    static constexpr int newton = 7;
+
+    static constexpr int bias = 16383;
+
+    static unsigned long long high(__float128 x)
+    {
+        unsigned long long w[2];
+        std::memcpy(w, &x, sizeof(x));
+        return w[1]; // Sign, 15 exponent bits and the top 48 mantissa bits
+    }
+    static __float128 pow2(int e) // e in [-16382, 16383]
+    {
+        const unsigned long long w[2] = {0, (unsigned long long)(e + bias) << 48};
+        __float128 x;
+        std::memcpy(&x, w, sizeof(x));
+        return x;
+    }
+
+    static __float128 epsilon() { return pow2(-112); }
+    static __float128 abs(__float128 x) { return signbit(x) ? -x : x; }
+    static bool isfinite(__float128 x) { return ((high(x) >> 48) & 0x7FFF) != 0x7FFF; }
+    static bool isnan(__float128 x) { return x != x; }
+    static bool signbit(__float128 x) { return high(x) >> 63; }
+    static __float128 split(__float128 x, int &e)
+    {
+        e = 0;
+        if (x == 0 || !isfinite(x))
+            return x;
+        int bias_e = int((high(x) >> 48) & 0x7FFF);
+        if (bias_e == 0) // Subnormal
+        {
+            x = x * pow2(113);
+            bias_e = int((high(x) >> 48) & 0x7FFF);
+            e = -113;
+        }
+        const int e2 = bias_e - (bias - 1);
+        e += e2;
+        return scale(x, -e2);
+    }
+    static __float128 scale(__float128 x, int e)
+    {
+        while (e > bias)
+        {
+            x = x * pow2(bias);
+            e -= bias;
+        }
+        while (e < 1 - bias)
+        {
+            x = x * pow2(1 - bias);
+            e -= 1 - bias;
+        }
+        return x * pow2(e);
+    }
+    static double to_double(__float128 x) { return double(x); }
+};
+#endif // __SIZEOF_FLOAT128__
+
+/// <summary>
+/// a x m, where m is 1 + 10^-k rounded to T: the step of the pseudo-division of ln(x) and of the
+/// pseudo-multiplication of exp(x). Decimal types overload it as the fused add/shift "a = a + (a >> k)"
+/// </summary>
+template <typename T>
+inline T mul_1p10(const T &a, const T &m, int)
+{
+    return a * m;
+}
+
+#include "fixed.h"
+#include "decimal.h"
+#include "bcd.h"
+#include "bid.h"
+#include "counted.h"
+
+// All number types the methods are instantiated for, X(type) is expanded once for each
+#ifdef __SIZEOF_FLOAT128__
+#define FOR_EACH_FLOAT128(X) X(__float128)
+#else
+#define FOR_EACH_FLOAT128(X)
+#endif
+
+#ifdef __SIZEOF_INT128__
+#define FOR_EACH_DECIMAL(X) X(Decimal) X(Dec64) X(Dec128)
+#else
+#define FOR_EACH_DECIMAL(X)
+#endif
+
+#define FOR_EACH_NUMBER_TYPE(X) X(float) X(double) X(long double) FOR_EACH_FLOAT128(X) X(Fixed) FOR_EACH_DECIMAL(X) X(Bcd) X(Counted)
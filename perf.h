@@ -0,0 +1,133 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+/// Hardware event counters of the calling thread, through perf_event_open() on Linux
+///
+/// Each event is opened on its own, so an event the CPU or the kernel does not offer is left out while
+/// the others count. When none opens, as in most containers, on a perf_event_paranoid setting that is
+/// too strict or off Linux, available() is false and why() tells the reason
+/// </summary>
+class PerfCounters
+{
+public:
+    enum Event { cycles, instructions, branch_misses, l1d_misses, l1i_misses, events };
+
+    static const char *name(Event e)
+    {
+        static const char *const names[] = {"cycles", "instructions", "branch-misses", "L1d-misses", "L1i-misses"};
+        return names[e];
+    }
+
+    PerfCounters()
+    {
+        for (int e = 0; e < events; e++)
+            fd[e] = -1;
+#ifdef __linux__
+        const struct { uint32_t type; uint64_t config; } ev[events] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1I | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16}};
+        int err = 0;
+        for (int e = 0; e < events; e++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = ev[e].type;
+            attr.config = ev[e].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd[e] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd[e] < 0)
+                err = errno;
+        }
+        if (!available())
+            std::snprintf(error, sizeof(error), "perf_event_open: %s%s", std::strerror(err),
+                          err == EACCES || err == EPERM ? ", see /proc/sys/kernel/perf_event_paranoid" : "");
+#else
+        std::snprintf(error, sizeof(error), "perf_event_open is Linux only");
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int e = 0; e < events; e++)
+            if (fd[e] >= 0)
+                close(fd[e]);
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const
+    {
+        for (int e = 0; e < events; e++)
+            if (fd[e] >= 0)
+                return true;
+        return false;
+    }
+    bool has(Event e) const { return fd[e] >= 0; }
+    const char *why() const { return error; }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int e = 0; e < events; e++)
+            if (fd[e] >= 0)
+            {
+                ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+    }
+
+    /// <summary>
+    /// Stop counting and read the counts, scaled up for the time an event shared its counter with others
+    /// </summary>
+    void stop()
+    {
+#ifdef __linux__
+        for (int e = 0; e < events; e++)
+            if (fd[e] >= 0)
+                ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < events; e++)
+        {
+            uint64_t v[3] = {}; // value, time enabled, time running
+            count[e] = 0;
+            if (fd[e] >= 0 && read(fd[e], v, sizeof(v)) == sizeof(v) && v[2])
+                count[e] = double(v[0]) * double(v[1]) / double(v[2]);
+        }
+#endif
+    }
+
+    double value(Event e) const { return count[e]; }
+
+private:
+    int fd[events];
+    double count[events] = {};
+    char error[128] = "";
+};
@@ -0,0 +1,290 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "methods.h"
+#include "registry.h"
+#include "simd.h"
+
+namespace
+{
+template <ScalarFn F>
+void loop(const double *in, double *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = F(in[i]);
+}
+
+double libm_sqrt(double x) { return std::sqrt(x); }
+double libm_log(double x) { return std::log(x); }
+double libm_exp(double x) { return std::exp(x); }
+double libm_tan(double x) { return std::tan(x); }
+double libm_atan(double x) { return std::atan(x); }
+
+// The methods are table-driven digit recurrences already, so the scalar method is also the table-driven one
+const Impl sqrt_impls[] = {{"scalar", sqrt1<double>, loop<sqrt1<double>>}, {"simd", nullptr, sqrt1_batch}, {"libm", libm_sqrt, loop<libm_sqrt>}};
+const Impl ln_impls[] = {{"scalar", ln1<double>, loop<ln1<double>>}, {"simd", nullptr, ln1_batch}, {"libm", libm_log, loop<libm_log>}};
+const Impl exp_impls[] = {{"scalar", exp1<double>, loop<exp1<double>>}, {"simd", nullptr, exp1_batch}, {"libm", libm_exp, loop<libm_exp>}};
+const Impl tan_impls[] = {{"scalar", tan1<double>, loop<tan1<double>>}, {"simd", nullptr, tan1_batch}, {"libm", libm_tan, loop<libm_tan>}};
+const Impl atan_impls[] = {{"scalar", atan1<double>, loop<atan1<double>>}, {"simd", nullptr, atan1_batch}, {"libm", libm_atan, loop<libm_atan>}};
+
+/// <summary>
+/// Implementations of a function, its long double reference and the inputs it is tuned over,
+/// those of bench_types(): 10^[lo, hi) for a log-uniform range, else [lo, hi]
+/// </summary>
+struct Function
+{
+    const char *name;
+    const Impl *impls;
+    size_t count;
+    long double (*ref)(long double);
+    double lo, hi;
+    bool log_uniform;
+};
+
+const Function functions[int(Fn::count)] = {
+    {"sqrt", sqrt_impls, std::size(sqrt_impls), [](long double x) { return std::sqrt(x); }, -2, 3, true},
+    {"ln", ln_impls, std::size(ln_impls), [](long double x) { return std::log(x); }, -2, 3, true},
+    {"exp", exp_impls, std::size(exp_impls), [](long double x) { return std::exp(x); }, -10, 10, false},
+    {"tan", tan_impls, std::size(tan_impls), [](long double x) { return std::tan(x); }, -1.5, 1.5, false},
+    {"atan", atan_impls, std::size(atan_impls), [](long double x) { return std::atan(x); }, -100, 100, false},
+};
+
+/// <summary>
+/// Vector units the batch kernels run on; winners cached for another level are not trusted
+/// </summary>
+const char *isa()
+{
+    return isa_name(Dispatch::level());
+}
+
+const Impl *find(const Function &fn, const char *name)
+{
+    for (size_t i = 0; i < fn.count; i++)
+        if (strcmp(fn.impls[i].name, name) == 0)
+            return &fn.impls[i];
+    return nullptr;
+}
+
+/// <summary>
+/// Best time over a few trials of one call of g() over all inputs, in ns per element
+/// </summary>
+template <typename G>
+double best_ns(G g, size_t count)
+{
+    const int trials = 5;
+    const int reps = 20;
+    double best = 1e300;
+    for (int t = 0; t < trials; t++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++)
+            g();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / (double(reps) * count));
+    }
+    return best;
+}
+} // namespace
+
+Registry::Registry()
+{
+    for (int f = 0; f < int(Fn::count); f++)
+        sel[f] = {find(functions[f], "scalar"), find(functions[f], "simd")};
+    load();
+}
+
+Registry &Registry::get()
+{
+    static Registry r;
+    return r;
+}
+
+const char *Registry::name(Fn f)
+{
+    return functions[int(f)].name;
+}
+
+const Impl *Registry::impls(Fn f, size_t &count) const
+{
+    count = functions[int(f)].count;
+    return functions[int(f)].impls;
+}
+
+std::vector<double> Registry::inputs(Fn f, size_t count, unsigned seed)
+{
+    const Function &fn = functions[int(f)];
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(fn.lo, fn.hi);
+    std::vector<double> in(count);
+    for (auto &x : in)
+        x = fn.log_uniform ? std::pow(10, dist(gen)) : dist(gen);
+    return in;
+}
+
+Range Registry::range(Fn f)
+{
+    const Function &fn = functions[int(f)];
+    if (fn.log_uniform)
+        return {std::pow(10, fn.lo), std::pow(10, fn.hi), true};
+    return {fn.lo, fn.hi, false};
+}
+
+long double Registry::reference(Fn f, long double x)
+{
+    return functions[int(f)].ref(x);
+}
+
+bool Registry::select_one(Fn f, const char *impl)
+{
+    const Impl *i = find(functions[int(f)], impl);
+    if (!i || !i->one)
+        return false;
+    sel[int(f)].one = i;
+    return true;
+}
+
+bool Registry::select_batch(Fn f, const char *impl)
+{
+    const Impl *i = find(functions[int(f)], impl);
+    if (!i || !i->batch)
+        return false;
+    sel[int(f)].batch = i;
+    return true;
+}
+
+/// <summary>
+/// Read the winners from a tune file: "isa <units>", then one "<function> <scalar impl> <array impl>" per line
+/// Returns false and keeps the current selection if the file is missing, malformed or from other vector units
+/// </summary>
+bool Registry::load(const char *path)
+{
+    std::ifstream file(path);
+    std::string key, value;
+    if (!(file >> key >> value) || key != "isa" || value != isa())
+        return false;
+
+    Registry tuned = *this;
+    std::string fn, one, batch;
+    while (file >> fn >> one >> batch)
+    {
+        int f = 0;
+        while (f < int(Fn::count) && fn != functions[f].name)
+            f++;
+        if (f == int(Fn::count) || !tuned.select_one(Fn(f), one.c_str()) || !tuned.select_batch(Fn(f), batch.c_str()))
+            return false;
+    }
+    *this = tuned;
+    return true;
+}
+
+bool Registry::save(const char *path) const
+{
+    std::ofstream file(path);
+    file << "isa " << isa() << "\n";
+    for (int f = 0; f < int(Fn::count); f++)
+        file << functions[f].name << " " << sel[f].one->name << " " << sel[f].batch->name << "\n";
+    return bool(file);
+}
+
+/// <summary>
+/// Time every implementation of every function on this machine and select the fastest for single values
+/// and for arrays. An implementation off by more than 1e-9 relative to long double is broken on this CPU and
+/// is not a candidate; the methods themselves lose a few digits near the zeros of ln and tan
+/// </summary>
+void Registry::tune(bool verbose)
+{
+    const size_t count = 4096;
+    const long double tolerance = 1e-9L;
+
+    if (verbose)
+    {
+        std::cout << "\n----- Implementations on this CPU (" << isa() << "): ns per call, ns per element of an array -----\n";
+        std::cout << "function  impl        scalar     array  max error\n";
+    }
+    for (int f = 0; f < int(Fn::count); f++)
+    {
+        const Function &fn = functions[f];
+        const std::vector<double> in = inputs(Fn(f), count, f + 1);
+        std::vector<double> out(count);
+
+        double best_one = 1e300, best_batch = 1e300;
+        for (size_t i = 0; i < fn.count; i++)
+        {
+            const Impl &impl = fn.impls[i];
+            long double err = 0;
+            for (size_t k = 0; k < count; k++)
+            {
+                const long double verif = fn.ref(in[k]);
+                if (impl.one)
+                    err = std::max(err, std::fabs((impl.one(in[k]) - verif) / verif));
+                if (impl.batch)
+                {
+                    impl.batch(&in[k], &out[k], 1);
+                    err = std::max(err, std::fabs((out[k] - verif) / verif));
+                }
+            }
+            if (impl.batch)
+            {
+                impl.batch(in.data(), out.data(), count); // The array path may differ from the one element path
+                for (size_t k = 0; k < count; k++)
+                    err = std::max(err, std::fabs((out[k] - fn.ref(in[k])) / fn.ref(in[k])));
+            }
+            const bool valid = err <= tolerance;
+
+            double ns_one = 0, ns_batch = 0;
+            if (impl.one)
+            {
+                ns_one = best_ns([&] {
+                    for (size_t k = 0; k < count; k++)
+                        out[k] = impl.one(in[k]);
+                }, count);
+                if (valid && ns_one < best_one)
+                {
+                    best_one = ns_one;
+                    sel[f].one = &impl;
+                }
+            }
+            if (impl.batch)
+            {
+                ns_batch = best_ns([&] { impl.batch(in.data(), out.data(), count); }, count);
+                if (valid && ns_batch < best_batch)
+                {
+                    best_batch = ns_batch;
+                    sel[f].batch = &impl;
+                }
+            }
+
+            if (verbose)
+            {
+                std::cout << std::left << std::setw(10) << fn.name << std::setw(8) << impl.name << std::right << std::fixed << std::setprecision(2);
+                if (impl.one)
+                    std::cout << std::setw(10) << ns_one;
+                else
+                    std::cout << std::setw(10) << "-";
+                if (impl.batch)
+                    std::cout << std::setw(10) << ns_batch;
+                else
+                    std::cout << std::setw(10) << "-";
+                std::cout << std::scientific << std::setprecision(1) << std::setw(11) << double(err) << (valid ? "" : "  rejected") << "\n";
+            }
+        }
+        if (verbose)
+            std::cout << std::left << std::setw(10) << fn.name << "selected " << sel[f].one->name << " for scalars, " << sel[f].batch->name << " for arrays\n" << std::right;
+    }
+}
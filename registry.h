@@ -0,0 +1,86 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// Functions with more than one implementation over double
+/// </summary>
+enum class Fn { sqrt, ln, exp, tan, atan, count };
+
+/// <summary>
+/// Inputs of a function: [lo, hi], spread log-uniformly over the magnitudes or uniformly
+/// </summary>
+struct Range
+{
+    double lo, hi;
+    bool log_uniform;
+};
+
+using ScalarFn = double (*)(double);
+using BatchFn = void (*)(const double *in, double *out, size_t count);
+
+/// <summary>
+/// One implementation of a function: a scalar entry point, an array entry point, or both
+/// </summary>
+struct Impl
+{
+    const char *name;
+    ScalarFn one;   // nullptr if it only works on arrays
+    BatchFn batch;  // nullptr if it only works on single values
+};
+
+/// <summary>
+/// The implementations of each function and the one selected for single values and for arrays
+///
+/// The selection starts with the methods of this program, scalar and SIMD, and is replaced by the
+/// winners the tuner cached in tune_file, if that file was written on a CPU with the same vector units.
+/// "calcmethods tune" benchmarks every implementation on this machine and rewrites the file
+/// </summary>
+class Registry
+{
+public:
+    static constexpr const char *tune_file = "calcmethods.tune";
+
+    static Registry &get();
+
+    double one(Fn f, double x) const { return sel[int(f)].one->one(x); }
+    void batch(Fn f, const double *in, double *out, size_t count) const { sel[int(f)].batch->batch(in, out, count); }
+
+    static const char *name(Fn f);
+    const Impl *impls(Fn f, size_t &count) const;
+
+    // Inputs a function is tuned and benchmarked over, those of bench_types()
+    static std::vector<double> inputs(Fn f, size_t count, unsigned seed = 1);
+    static Range range(Fn f);
+
+    // Long double value of the function, the reference of the tuner and of the accuracy sweep
+    static long double reference(Fn f, long double x);
+
+    const Impl &selected_one(Fn f) const { return *sel[int(f)].one; }
+    const Impl &selected_batch(Fn f) const { return *sel[int(f)].batch; }
+
+    // Select an implementation by name; false if f has no such implementation of that kind
+    bool select_one(Fn f, const char *impl);
+    bool select_batch(Fn f, const char *impl);
+
+    bool load(const char *path = tune_file);
+    bool save(const char *path = tune_file) const;
+    void tune(bool verbose);
+
+private:
+    Registry();
+
+    struct Selection
+    {
+        const Impl *one;
+        const Impl *batch;
+    } sel[int(Fn::count)];
+};
@@ -0,0 +1,179 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+// Batch kernels are compiled per function for their instruction set with target attributes,
+// so the rest of the program stays baseline x86-64 and the kernel is picked at run time
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+
+inline bool cpu_has_sse42() { return __builtin_cpu_supports("sse4.2"); }
+inline bool cpu_has_avx2() { return __builtin_cpu_supports("avx2"); }
+inline bool cpu_has_avx512() { return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"); }
+
+/// <summary>
+/// Lanes of one vector unit for LaneDigits in digits.h: V holds a double per lane, M selects lanes
+/// inc() adds 1 to the selected lanes, below() selects the lanes where a < b, add_mul() is r + d x w
+/// </summary>
+struct Sse42Lanes
+{
+    using V = __m128d;
+    using M = __m128d;
+
+    TARGET_SSE42 static V zero() { return _mm_setzero_pd(); }
+    TARGET_SSE42 static M all() { return _mm_castsi128_pd(_mm_set1_epi64x(-1)); }
+    TARGET_SSE42 static bool any(M m) { return _mm_movemask_pd(m) != 0; }
+    TARGET_SSE42 static V inc(V d, M m) { return _mm_add_pd(d, _mm_and_pd(m, _mm_set1_pd(1.0))); }
+    TARGET_SSE42 static M below(V a, V b) { return _mm_cmplt_pd(a, b); }
+    TARGET_SSE42 static V add_mul(V r, V d, double w) { return _mm_add_pd(r, _mm_mul_pd(d, _mm_set1_pd(w))); }
+};
+
+struct Avx2Lanes
+{
+    using V = __m256d;
+    using M = __m256d;
+
+    TARGET_AVX2 static V zero() { return _mm256_setzero_pd(); }
+    TARGET_AVX2 static M all() { return _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); }
+    TARGET_AVX2 static bool any(M m) { return _mm256_movemask_pd(m) != 0; }
+    TARGET_AVX2 static V inc(V d, M m) { return _mm256_add_pd(d, _mm256_and_pd(m, _mm256_set1_pd(1.0))); }
+    TARGET_AVX2 static M below(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    TARGET_AVX2 static V add_mul(V r, V d, double w) { return _mm256_add_pd(r, _mm256_mul_pd(d, _mm256_set1_pd(w))); }
+};
+
+struct Avx512Lanes
+{
+    using V = __m512d;
+    using M = __mmask8;
+
+    TARGET_AVX512 static V zero() { return _mm512_setzero_pd(); }
+    TARGET_AVX512 static M all() { return 0xFF; }
+    TARGET_AVX512 static bool any(M m) { return m != 0; }
+    TARGET_AVX512 static V inc(V d, M m) { return _mm512_mask_add_pd(d, m, d, _mm512_set1_pd(1.0)); }
+    TARGET_AVX512 static M below(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    TARGET_AVX512 static V add_mul(V r, V d, double w) { return _mm512_add_pd(r, _mm512_mul_pd(d, _mm512_set1_pd(w))); }
+};
+#else
+#define HAVE_X86_SIMD 0
+#endif
+
+/// <summary>
+/// Instruction set levels of the batch kernels, each one a superset of the one before
+/// </summary>
+enum class Isa { scalar, sse42, avx2, avx512, count };
+
+inline const char *isa_name(Isa isa)
+{
+    static const char *const names[] = {"scalar", "sse4.2", "avx2", "avx512"};
+    return names[int(isa)];
+}
+
+/// <summary>
+/// Highest level this CPU supports
+/// </summary>
+inline Isa cpu_isa()
+{
+#if HAVE_X86_SIMD
+    if (cpu_has_avx512())
+        return Isa::avx512;
+    if (cpu_has_avx2())
+        return Isa::avx2;
+    if (cpu_has_sse42())
+        return Isa::sse42;
+#endif
+    return Isa::scalar;
+}
+
+using BatchKernel = void (*)(const double *in, double *out, size_t count);
+
+/// <summary>
+/// Batch entry point of one function: a kernel per Isa level, resolved to a single pointer when it is
+/// constructed, so a call is one indirect jump. A level without a kernel of its own uses the one below
+/// Each batch function holds its Dispatch as a function-local static, so it is resolved on the first
+/// call, also from a static constructor of another file, and the construction is thread safe
+///
+/// The level is the highest one the CPU supports, or a lower one forced with the environment variable
+/// NUMMETHODS_ISA=scalar|sse4.2|avx2|avx512 or with force(), to benchmark one level against another
+/// </summary>
+class Dispatch
+{
+public:
+    Dispatch(BatchKernel scalar, BatchKernel sse42 = nullptr, BatchKernel avx2 = nullptr, BatchKernel avx512 = nullptr)
+        : kernels{scalar, sse42, avx2, avx512}, next(head().load())
+    {
+        resolve();
+        while (!head().compare_exchange_weak(next, this))
+            ;
+    }
+
+    Dispatch(const Dispatch &) = delete;
+    Dispatch &operator=(const Dispatch &) = delete;
+
+    void operator()(const double *in, double *out, size_t count) const { kernel(in, out, count); }
+
+    static Isa level() { return current(); }
+
+    /// <summary>
+    /// Resolve every entry point constructed so far again for isa, and the later ones for it too; false,
+    /// and nothing changes, if the CPU does not support it. Not thread safe: call it while no batch function runs
+    /// </summary>
+    static bool force(Isa isa)
+    {
+        if (isa > cpu_isa())
+            return false;
+        current() = isa;
+        for (Dispatch *d = head().load(); d; d = d->next)
+            d->resolve();
+        return true;
+    }
+
+private:
+    static std::atomic<Dispatch *> &head()
+    {
+        static std::atomic<Dispatch *> list{nullptr};
+        return list;
+    }
+
+    static Isa &current()
+    {
+        static Isa isa = initial();
+        return isa;
+    }
+
+    static Isa initial()
+    {
+        const Isa best = cpu_isa();
+        if (const char *forced = std::getenv("NUMMETHODS_ISA"))
+            for (int i = 0; i <= int(best); i++)
+                if (std::strcmp(forced, isa_name(Isa(i))) == 0)
+                    return Isa(i);
+        return best;
+    }
+
+    void resolve()
+    {
+        int i = int(current());
+        while (!kernels[i])
+            i--;
+        kernel = kernels[i];
+    }
+
+    BatchKernel kernels[int(Isa::count)];
+    BatchKernel kernel;
+    Dispatch *next;
+};
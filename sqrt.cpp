@@ -5,9 +5,35 @@
     the Free Software Foundation, either version 3 of the License, or
     (at your option) any later version.
 */
-#include <iostream>
-#include <iomanip>
 #include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include "tables.h"
+#include "methods.h"
+#include "simd.h"
+
+// With the 7-bit seed, Newton reaches full double precision in 3 iterations and confirms it in the 4th;
+// this is the hard ceiling and the worst-case latency of sqrt1() on double, and of its SIMD kernels
+constexpr auto MAX_ITER = num_traits<double>::newton;
+
+/// <summary>
+/// Initial guess of sqrt(f) for f in [1/radix^2, 1), good to about 7 bits
+/// A binary mantissa indexes the table directly, a decimal one is first brought to [0.25, 1) by an even power of 2
+/// </summary>
+static double sqrt_guess(double f)
+{
+    if (f >= 0.25)
+        return sqrt_seed[int(f * 64) - 16];
+
+    int exp;
+    f = frexp(f, &exp);
+    if (exp & 1)
+    {
+        f = f / 2;
+        exp++;
+    }
+    return ldexp(sqrt_seed[int(f * 64) - 16], exp / 2);
+}
 
 /// <summary>
 /// Compute sqrt(x)
@@ -16,51 +42,219 @@
 /// Domain: x >= 0 (all non-negative real numbers)
 /// Range: All non-negative real numbers
 /// </summary>
-double sqrt1(const double n)
+template <typename T>
+T sqrt1(const T n)
 {
+    using nt = num_traits<T>;
+
     if (n < 0)
     {
         return 0; // Error: Invalid input value
     }
 
-    // XXX here we adjust the exponent to be even, possibly shifting the mantissa
-    // ...
-
     if (n == 0)
         return 0; // Handle zero as a special case
+    if (!nt::isfinite(n))
+        return n;
+
+    // Adjust the exponent to be even, possibly shifting the mantissa, so it can be halved:
+    // sqrt(mant x radix^exp) = sqrt(mant) x radix^(exp/2), with mant in [1/radix^2,1)
+    // In BCD this is a decimal exponent and a one digit shift of the mantissa
+    int exp;
+    T mant = nt::split(n, exp); // mant in [1/radix,1)
+    if (exp & 1)
+    {
+        mant = mant / nt::radix;
+        exp++;
+    }
 
-    double last;
-    double result = n / 10; // Initial guess: a simple BCD shift right
+    T last;
+    T result = T(sqrt_guess(nt::to_double(mant))); // Initial guess from the leading mantissa digits
     int loop_cnt = 0; // Convergence loop counter, only used for stats
     do
     {
         last = result;
-        double sx = n / last;
+        T sx = mant / last;
         result = (last + sx) / 2;
 
         loop_cnt++;
 
-        // Implement as tracking of how many digits remained the same between the last and [new] result
-        // Once all digits are the same, the requred degree of convergence has been reached
-    } while (fabs(last - result) > 1e-15); // Pick a digit on the LSB side
+        // Track how many digits remained the same between the last and [new] result, relative to the
+        // result: once all but the LSB are the same, the required degree of convergence has been reached.
+        // Rounding can make the last step alternate between two neighbours, so the loop count is capped
+    } while (nt::abs(last - result) > result * nt::epsilon() && loop_cnt < nt::newton);
 
     //std::cout << "Converged in " << loop_cnt << " iterations\n";
 
-    return result;
+    return nt::scale(result, exp / 2);
+}
+
+#define INSTANTIATE(T) template T sqrt1<T>(const T);
+FOR_EACH_NUMBER_TYPE(INSTANTIATE)
+#undef INSTANTIATE
+
+#if HAVE_X86_SIMD
+/// <summary>
+/// sqrt1() on 2 lanes at once, see sqrt1_avx2(); without a gather, the two seeds are loaded one by one
+/// </summary>
+TARGET_SSE42 static void sqrt1_sse42(const double *in, double *out, size_t count)
+{
+    const __m128d eps = _mm_set1_pd(DBL_EPSILON);
+    const __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+    const __m128i mant_mask = _mm_set1_epi64x(0x000FFFFFFFFFFFFF);
+    const __m128i one = _mm_set1_epi64x(1);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128i bits = _mm_castpd_si128(_mm_loadu_pd(in + i));
+        const __m128i e = _mm_srli_epi64(bits, 52); // Includes the sign, so negative lanes are out of range
+        const __m128i normal = _mm_and_si128(_mm_cmpgt_epi64(e, _mm_setzero_si128()), _mm_cmpgt_epi64(_mm_set1_epi64x(2047), e));
+        if (_mm_movemask_pd(_mm_castsi128_pd(normal)) != 0x3)
+        {
+            for (int j = 0; j < 2; j++)
+                out[i + j] = sqrt1(in[i + j]);
+            continue;
+        }
+
+        const __m128i odd = _mm_and_si128(e, one);
+        const __m128d mant = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, mant_mask), _mm_slli_epi64(_mm_sub_epi64(_mm_set1_epi64x(1022), odd), 52)));
+        const __m128d scale = _mm_castsi128_pd(_mm_slli_epi64(_mm_srli_epi64(_mm_add_epi64(_mm_add_epi64(e, odd), _mm_set1_epi64x(1024)), 1), 52));
+
+        const __m128i idx = _mm_sub_epi32(_mm_cvttpd_epi32(_mm_mul_pd(mant, _mm_set1_pd(64))), _mm_set1_epi32(16));
+        __m128d result = _mm_setr_pd(sqrt_seed.v[_mm_cvtsi128_si32(idx)], sqrt_seed.v[_mm_extract_epi32(idx, 1)]);
+        __m128d active = _mm_castsi128_pd(_mm_set1_epi64x(-1));
+        for (int loop_cnt = 0; loop_cnt < MAX_ITER; loop_cnt++)
+        {
+            const __m128d last = result;
+            const __m128d next = _mm_mul_pd(_mm_add_pd(last, _mm_div_pd(mant, last)), _mm_set1_pd(0.5));
+            result = _mm_blendv_pd(result, next, active);
+
+            const __m128d diff = _mm_and_pd(_mm_sub_pd(last, result), abs_mask);
+            active = _mm_and_pd(active, _mm_cmpgt_pd(diff, _mm_mul_pd(result, eps)));
+            if (_mm_movemask_pd(active) == 0)
+                break;
+        }
+
+        _mm_storeu_pd(out + i, _mm_mul_pd(result, scale));
+    }
+
+    for (; i < count; i++)
+        out[i] = sqrt1(in[i]);
 }
 
-#define SQRT(x) sqrt1(x)
+/// <summary>
+/// sqrt1() on 4 lanes at once: the same normalization, seed and Newton steps as the scalar code,
+/// so results are identical; each lane leaves the Newton loop on its own convergence test
+/// Vectors with a lane that is not a positive normal number go through the scalar code
+/// </summary>
+TARGET_AVX2 static void sqrt1_avx2(const double *in, double *out, size_t count)
+{
+    const __m256d eps = _mm256_set1_pd(DBL_EPSILON);
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+    const __m256i mant_mask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFF);
+    const __m256i one = _mm256_set1_epi64x(1);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256i bits = _mm256_castpd_si256(_mm256_loadu_pd(in + i));
+        const __m256i e = _mm256_srli_epi64(bits, 52); // Includes the sign, so negative lanes are out of range
+        const __m256i normal = _mm256_and_si256(_mm256_cmpgt_epi64(e, _mm256_setzero_si256()), _mm256_cmpgt_epi64(_mm256_set1_epi64x(2047), e));
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(normal)) != 0xF)
+        {
+            for (int j = 0; j < 4; j++)
+                out[i + j] = sqrt1(in[i + j]);
+            continue;
+        }
+
+        // mant in [0.25,1) and an even exponent, as frexp() and the odd exponent adjustment do
+        const __m256i odd = _mm256_and_si256(e, one);
+        const __m256d mant = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mant_mask), _mm256_slli_epi64(_mm256_sub_epi64(_mm256_set1_epi64x(1022), odd), 52)));
+        const __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(_mm256_add_epi64(_mm256_add_epi64(e, odd), _mm256_set1_epi64x(1024)), 1), 52));
 
-void algo_sqrt()
+        const __m128i idx = _mm_sub_epi32(_mm256_cvttpd_epi32(_mm256_mul_pd(mant, _mm256_set1_pd(64))), _mm_set1_epi32(16));
+        __m256d result = _mm256_i32gather_pd(sqrt_seed.v, idx, 8);
+        __m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (int loop_cnt = 0; loop_cnt < MAX_ITER; loop_cnt++)
+        {
+            const __m256d last = result;
+            const __m256d next = _mm256_mul_pd(_mm256_add_pd(last, _mm256_div_pd(mant, last)), _mm256_set1_pd(0.5));
+            result = _mm256_blendv_pd(result, next, active);
+
+            const __m256d diff = _mm256_and_pd(_mm256_sub_pd(last, result), abs_mask);
+            active = _mm256_and_pd(active, _mm256_cmp_pd(diff, _mm256_mul_pd(result, eps), _CMP_GT_OQ));
+            if (_mm256_movemask_pd(active) == 0)
+                break;
+        }
+
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(result, scale));
+    }
+
+    for (; i < count; i++)
+        out[i] = sqrt1(in[i]);
+}
+
+/// <summary>
+/// sqrt1() on 8 lanes at once, see sqrt1_avx2()
+/// </summary>
+TARGET_AVX512 static void sqrt1_avx512(const double *in, double *out, size_t count)
 {
-    const double tests_sqrt[] = {0,54757,125348,0.5,0.00035,0.02,1,1.234e78};
+    const __m512d eps = _mm512_set1_pd(DBL_EPSILON);
+    const __m512i mant_mask = _mm512_set1_epi64(0x000FFFFFFFFFFFFF);
+    const __m512i one = _mm512_set1_epi64(1);
 
-    std::cout << "\n----- SQRT(x) -----\n";
-    for (int i = 0; i < sizeof(tests_sqrt) / sizeof(double); i++)
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
     {
-        const double x = tests_sqrt[i];
-        const double verif = sqrt(x);
-        const double result = SQRT(x);
-        std::cout << std::setprecision(15) << "x=" << x << " result=" << result << "  verif=" << verif << " error=" << verif - result << "\n";
+        const __m512i bits = _mm512_castpd_si512(_mm512_loadu_pd(in + i));
+        const __m512i e = _mm512_srli_epi64(bits, 52); // Includes the sign, so negative lanes are out of range
+        const __mmask8 normal = _mm512_cmpgt_epi64_mask(e, _mm512_setzero_si512()) & _mm512_cmplt_epi64_mask(e, _mm512_set1_epi64(2047));
+        if (normal != 0xFF)
+        {
+            for (int j = 0; j < 8; j++)
+                out[i + j] = sqrt1(in[i + j]);
+            continue;
+        }
+
+        const __m512i odd = _mm512_and_si512(e, one);
+        const __m512d mant = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, mant_mask), _mm512_slli_epi64(_mm512_sub_epi64(_mm512_set1_epi64(1022), odd), 52)));
+        const __m512d scale = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_srli_epi64(_mm512_add_epi64(_mm512_add_epi64(e, odd), _mm512_set1_epi64(1024)), 1), 52));
+
+        const __m256i idx = _mm256_sub_epi32(_mm512_cvttpd_epi32(_mm512_mul_pd(mant, _mm512_set1_pd(64))), _mm256_set1_epi32(16));
+        __m512d result = _mm512_i32gather_pd(idx, sqrt_seed.v, 8);
+        __mmask8 active = 0xFF;
+        for (int loop_cnt = 0; loop_cnt < MAX_ITER && active; loop_cnt++)
+        {
+            const __m512d last = result;
+            result = _mm512_mask_mul_pd(result, active, _mm512_add_pd(last, _mm512_div_pd(mant, last)), _mm512_set1_pd(0.5));
+            const __m512d diff = _mm512_abs_pd(_mm512_sub_pd(last, result));
+            active &= _mm512_cmp_pd_mask(diff, _mm512_mul_pd(result, eps), _CMP_GT_OQ);
+        }
+
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(result, scale));
     }
+
+    for (; i < count; i++)
+        out[i] = sqrt1(in[i]);
+}
+#endif // HAVE_X86_SIMD
+
+static void sqrt1_scalar(const double *in, double *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = sqrt1(in[i]);
+}
+
+/// <summary>
+/// Compute sqrt(x) of count values, with the kernel of the widest vector unit of the CPU
+/// </summary>
+void sqrt1_batch(const double *in, double *out, size_t count)
+{
+#if HAVE_X86_SIMD
+    static Dispatch dispatch(sqrt1_scalar, sqrt1_sse42, sqrt1_avx2, sqrt1_avx512);
+#else
+    static Dispatch dispatch(sqrt1_scalar);
+#endif
+    dispatch(in, out, count);
 }
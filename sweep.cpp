@@ -0,0 +1,263 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "sweep.h"
+#include "registry.h"
+
+// Accuracy sweep: the error in units in the last place of every implementation of the registry against
+// its long double reference, over many more inputs than the algo_ checks, on all hardware threads
+
+namespace
+{
+const size_t chunk = 4096; // Inputs a thread takes at a time, and the unit of the sampling seeds
+
+/// <summary>
+/// Error of y in ulps of the double nearest to ref; infinite when one of them is not finite and the
+/// other is not the same, which is counted apart from the finite errors
+/// </summary>
+double ulp_error(double y, long double ref)
+{
+    if (!std::isfinite(ref) || !std::isfinite(y))
+        return (y == ref || (std::isnan(y) && std::isnan(ref))) ? 0 : INFINITY;
+    const int e = std::fabs(ref) < DBL_MIN ? DBL_MIN_EXP - 1 : std::ilogb(ref);
+    return double(std::fabs(y - ref) / std::ldexp(1.0L, e - (DBL_MANT_DIG - 1)));
+}
+
+/// <summary>
+/// Keys of the float32 values in order: consecutive floats have consecutive keys, +0 is 0 and -0 has none
+/// </summary>
+int64_t float_key(float x)
+{
+    uint32_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b >> 31 ? -int64_t(b & 0x7FFFFFFF) : int64_t(b);
+}
+
+float key_float(int64_t k)
+{
+    const uint32_t b = k < 0 ? uint32_t(-k) | 0x80000000 : uint32_t(k);
+    float x;
+    std::memcpy(&x, &b, sizeof(x));
+    return x;
+}
+
+/// <summary>
+/// Largest error, where it is, and the sum of the finite errors, of one thread or of all of them
+/// </summary>
+struct Error
+{
+    double max = 0;
+    double max_x = NAN;
+    double sum = 0;
+    uint64_t count = 0;
+    uint64_t wrong = 0; // Non-finite result where the reference is finite, or the other way around
+
+    void add(double x, double ulp)
+    {
+        if (std::isinf(ulp))
+        {
+            wrong++;
+            return;
+        }
+        if (ulp > max || std::isnan(max_x))
+        {
+            max = ulp;
+            max_x = x;
+        }
+        sum += ulp;
+        count++;
+    }
+
+    void merge(const Error &e)
+    {
+        if (e.max > max || (std::isnan(max_x) && !std::isnan(e.max_x)))
+        {
+            max = e.max;
+            max_x = e.max_x;
+        }
+        sum += e.sum;
+        count += e.count;
+        wrong += e.wrong;
+    }
+};
+
+/// <summary>
+/// Inputs of a sweep: input i is sample i of [lo, hi], seeded per chunk so that the inputs do not
+/// depend on the number of threads, or the float32 value of key first + i
+/// </summary>
+struct Inputs
+{
+    SweepOptions::Kind kind;
+    double lo, hi;
+    uint64_t total;
+    int64_t first = 0;
+
+    void fill(uint64_t c, double *in, size_t n) const
+    {
+        if (kind == SweepOptions::float32)
+        {
+            for (size_t i = 0; i < n; i++)
+                in[i] = key_float(first + int64_t(c * chunk + i));
+            return;
+        }
+        std::mt19937_64 gen(c + 1);
+        if (kind == SweepOptions::uniform)
+        {
+            std::uniform_real_distribution<double> dist(lo, hi);
+            for (size_t i = 0; i < n; i++)
+                in[i] = dist(gen);
+            return;
+        }
+        // Log-uniform over the magnitudes of a range of one sign
+        const double sign = hi < 0 ? -1 : 1;
+        std::uniform_real_distribution<double> dist(std::log10(std::min(sign * lo, sign * hi)), std::log10(std::max(sign * lo, sign * hi)));
+        for (size_t i = 0; i < n; i++)
+            in[i] = sign * std::pow(10, dist(gen));
+    }
+
+    std::string describe() const
+    {
+        static const char *const kinds[] = {"uniform", "log", "float32"};
+        std::ostringstream s;
+        s << kinds[kind] << " [" << std::setprecision(6) << lo << "," << hi << "]";
+        return s.str();
+    }
+};
+
+/// <summary>
+/// One thread of a sweep: take chunks of the inputs until none is left and return their error in err
+/// The error is kept in a local and stored once, as the Error of the threads share cache lines
+/// </summary>
+void work(Fn f, const Impl &impl, const Inputs &inputs, std::atomic<uint64_t> &next, Error &err)
+{
+    Error local;
+    std::vector<double> in(chunk), out(chunk);
+    for (uint64_t c = next++; c * chunk < inputs.total; c = next++)
+    {
+        const size_t n = size_t(std::min<uint64_t>(chunk, inputs.total - c * chunk));
+        inputs.fill(c, in.data(), n);
+        if (impl.batch)
+            impl.batch(in.data(), out.data(), n);
+        else
+            for (size_t i = 0; i < n; i++)
+                out[i] = impl.one(in[i]);
+        for (size_t i = 0; i < n; i++)
+            local.add(in[i], ulp_error(out[i], Registry::reference(f, in[i])));
+    }
+    err = local;
+}
+
+/// <summary>
+/// Inputs of one function from the options and the range of the registry; false with a message if invalid
+/// </summary>
+bool make_inputs(Fn f, const SweepOptions &opt, Inputs &inputs)
+{
+    const Range range = Registry::range(f);
+    inputs.lo = std::isnan(opt.lo) ? range.lo : opt.lo;
+    inputs.hi = std::isnan(opt.hi) ? range.hi : opt.hi;
+    inputs.kind = opt.kind != SweepOptions::automatic ? opt.kind : range.log_uniform ? SweepOptions::log_uniform : SweepOptions::uniform;
+    inputs.total = uint64_t(opt.count);
+    if (!(inputs.lo <= inputs.hi))
+    {
+        std::cerr << "Empty range [" << inputs.lo << "," << inputs.hi << "]\n";
+        return false;
+    }
+    if (inputs.kind == SweepOptions::log_uniform && !(inputs.lo > 0 || inputs.hi < 0))
+    {
+        std::cerr << "A log range needs lo and hi of the same sign, not [" << inputs.lo << "," << inputs.hi << "]\n";
+        return false;
+    }
+    if (inputs.kind == SweepOptions::float32)
+    {
+        // Every float32 value in [lo, hi]
+        float lo = float(inputs.lo), hi = float(inputs.hi);
+        if (lo < inputs.lo)
+            lo = std::nextafter(lo, INFINITY);
+        if (hi > inputs.hi)
+            hi = std::nextafter(hi, -INFINITY);
+        inputs.first = float_key(lo);
+        inputs.total = lo <= hi ? uint64_t(float_key(hi) - inputs.first + 1) : 0;
+    }
+    return true;
+}
+} // namespace
+
+/// <summary>
+/// Error in ulps of the selected implementations of the selected functions, one row per implementation
+/// with the largest error and its input, the mean error and the count of results that are not finite
+/// where the reference is, or the other way around. Returns false for an unknown function, implementation
+/// or an invalid range
+/// </summary>
+bool sweep(const SweepOptions &opt)
+{
+    const int threads = opt.threads > 0 ? opt.threads : std::max(1, int(std::thread::hardware_concurrency()));
+    bool found = false;
+
+    for (int f = 0; f < int(Fn::count); f++)
+    {
+        if (!opt.fn.empty() && opt.fn != Registry::name(Fn(f)))
+            continue;
+        Inputs inputs;
+        if (!make_inputs(Fn(f), opt, inputs))
+            return false;
+
+        size_t n;
+        const Impl *impls = Registry::get().impls(Fn(f), n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const Impl &impl = impls[i];
+            if (!opt.impl.empty() && opt.impl != impl.name)
+                continue;
+            if (!found)
+            {
+                std::cout << "\n----- Error in ulps against long double, " << threads << (threads == 1 ? " thread" : " threads") << " -----\n";
+                std::cout << "function impl    inputs                         count       max ulp  at x                      mean ulp  wrong      s\n";
+            }
+            found = true;
+
+            const auto start = std::chrono::steady_clock::now();
+            std::atomic<uint64_t> next{0};
+            std::vector<Error> errors(threads);
+            std::vector<std::thread> pool;
+            for (int t = 0; t < threads; t++)
+                pool.emplace_back(work, Fn(f), std::cref(impl), std::cref(inputs), std::ref(next), std::ref(errors[t]));
+            Error err;
+            for (int t = 0; t < threads; t++)
+            {
+                pool[t].join();
+                err.merge(errors[t]);
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << std::left << std::setw(9) << Registry::name(Fn(f)) << std::setw(8) << impl.name << std::setw(27) << inputs.describe()
+                      << std::right << std::setw(12) << inputs.total << std::fixed << std::setprecision(3) << std::setw(14) << err.max << "  "
+                      << std::left << std::setw(24) << std::defaultfloat << std::setprecision(17);
+            if (err.count)
+                std::cout << err.max_x;
+            else
+                std::cout << "-";
+            std::cout << std::right << std::fixed << std::setprecision(4) << std::setw(10) << (err.count ? err.sum / err.count : 0)
+                      << std::setw(7) << err.wrong << std::setprecision(1) << std::setw(7) << seconds << "\n";
+        }
+    }
+    if (!found)
+        std::cerr << "No implementation " << (opt.impl.empty() ? "" : opt.impl + " ") << "of " << (opt.fn.empty() ? "any function" : opt.fn) << "\n";
+    return found;
+}
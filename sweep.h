@@ -0,0 +1,71 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/// <summary>
+/// Settings of the accuracy sweep, from "name=value" arguments on the command line
+///
+/// fn and impl name a function and an implementation of the registry, or are empty for all of them.
+/// The inputs are count samples of [lo, hi], or every float32 value in it; lo and hi default to the
+/// range the registry tunes the function over
+/// </summary>
+struct SweepOptions
+{
+    enum Kind { uniform, log_uniform, float32, automatic };
+
+    std::string fn;              // Function, or all
+    std::string impl;            // Implementation, or all
+    Kind kind = automatic;       // Sampling; automatic is that of the registry range
+    double lo = NAN, hi = NAN;   // Inputs; NaN for the registry range
+    double count = 1e7;          // Samples of the uniform and log-uniform ranges
+    int threads = 0;             // Worker threads; 0 for one per hardware thread
+
+    /// <summary>
+    /// Set one option from "name=value"; false if it is not one of ours or the value is not valid
+    /// </summary>
+    bool set(const char *arg)
+    {
+        const char *eq = std::strchr(arg, '=');
+        if (!eq)
+            return false;
+        const std::string name(arg, eq - arg), value(eq + 1);
+        if (name == "fn")
+            fn = value == "all" ? "" : value;
+        else if (name == "impl")
+            impl = value == "all" ? "" : value;
+        else if (name == "range")
+        {
+            if (value == "uniform")
+                kind = uniform;
+            else if (value == "log")
+                kind = log_uniform;
+            else if (value == "float")
+                kind = float32;
+            else
+                return false;
+        }
+        else if (name == "lo")
+            lo = std::atof(value.c_str());
+        else if (name == "hi")
+            hi = std::atof(value.c_str());
+        else if (name == "count")
+            count = std::atof(value.c_str());
+        else if (name == "threads")
+            threads = std::atoi(value.c_str());
+        else
+            return false;
+        return true;
+    }
+};
+
+bool sweep(const SweepOptions &opt);
@@ -0,0 +1,208 @@
+/*  Copyright (C) 2021  Goran Devic
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+*/
+#pragma once
+
+// Constant tables shared by the numerical methods. All values are computed by the
+// compiler so no function pays for building its tables at runtime.
+
+namespace ct
+{
+/// <summary>
+/// Compile-time natural logarithm, used only to generate the tables below
+/// ln(x) = k*ln(2) + 2*atanh((m-1)/(m+1)), where x = m * 2^k and m is in [0.75, 1.5)
+/// Evaluated in long double so the final rounding to double matches libm log()
+/// </summary>
+constexpr long double ln(long double x)
+{
+    // atanh(1/3) series gives ln(2) quickly and precisely
+    long double ln2 = 0;
+    {
+        const long double z = 1.0L / 3.0L;
+        long double term = z;
+        for (int k = 1; k < 80; k += 2)
+        {
+            ln2 += term / k;
+            term *= z * z;
+        }
+        ln2 *= 2;
+    }
+
+    int e = 0;
+    while (x >= 1.5L) { x /= 2; e++; }
+    while (x < 0.75L) { x *= 2; e--; }
+
+    const long double z = (x - 1) / (x + 1);
+    long double sum = 0;
+    long double term = z;
+    for (int k = 1; k < 80; k += 2)
+    {
+        sum += term / k;
+        term *= z * z;
+    }
+    return e * ln2 + 2 * sum;
+}
+} // namespace ct
+
+// Multipliers used by the pseudo-division and pseudo-multiplication of ln(x) and exp(x)
+// With BCD, multiplying by these values is a fused add/shift: "a = a + (a >> k)"
+alignas(64) inline constexpr double ln_mul[] = {10, 2, 1.1, 1.01, 1.001, 1.0001, 1.00001, 1.000001, 1.0000001, 1.00000001};
+
+// Natural logarithms of the multipliers above: ln_logs[j] == log(ln_mul[j])
+alignas(64) inline constexpr double ln_logs[] = {
+    double(ct::ln(ln_mul[0])), double(ct::ln(ln_mul[1])), double(ct::ln(ln_mul[2])), double(ct::ln(ln_mul[3])), double(ct::ln(ln_mul[4])),
+    double(ct::ln(ln_mul[5])), double(ct::ln(ln_mul[6])), double(ct::ln(ln_mul[7])), double(ct::ln(ln_mul[8])), double(ct::ln(ln_mul[9]))};
+
+constexpr double ln10 = ln_logs[0];
+
+namespace ct
+{
+/// <summary>
+/// Compile-time 10^k correctly rounded to double
+/// The power is formed exactly as a multi-word integer and rounded once to 53 bits
+/// </summary>
+constexpr double pow10(int k)
+{
+    unsigned int w[34] = {1}; // 10^308 needs 1023 bits
+    int n = 1;
+    for (int i = 0; i < k; i++)
+    {
+        unsigned long long carry = 0;
+        for (int j = 0; j < n; j++)
+        {
+            carry += w[j] * 10ULL;
+            w[j] = unsigned(carry);
+            carry >>= 32;
+        }
+        if (carry)
+            w[n++] = unsigned(carry);
+    }
+
+    int bits = 32 * n;
+    while (!(w[n - 1] >> ((bits - 1) % 32)))
+        bits--;
+
+    // Take the top 53 bits, the next one is the rounding bit, all below it are sticky
+    unsigned long long m = 0;
+    bool round = false, sticky = false;
+    for (int b = bits - 1; b >= 0; b--)
+    {
+        const bool bit = (w[b / 32] >> (b % 32)) & 1;
+        if (b >= bits - 53)
+            m = (m << 1) | bit;
+        else if (b == bits - 54)
+            round = bit;
+        else
+            sticky = sticky || bit;
+    }
+    if (round && (sticky || (m & 1)))
+        m++;
+
+    double r = double(m);
+    for (int b = 53; b < bits; b++)
+        r *= 2;
+    return r;
+}
+
+/// <summary>
+/// Powers of ten 10^0 .. 10^(N-1)
+/// </summary>
+template <int N>
+struct Pow10
+{
+    double v[N];
+    constexpr Pow10() : v()
+    {
+        for (int i = 0; i < N; i++)
+            v[i] = pow10(i);
+    }
+    constexpr double operator[](int i) const { return v[i]; }
+};
+} // namespace ct
+
+// Powers of ten covering the whole exponent range of a double, used to split a
+// binary value into a decimal mantissa and exponent in a constant time
+alignas(64) inline constexpr ct::Pow10<309> pow10_table{};
+
+// Binary digits of 2/pi, 32 bits per word, most significant word first: 2/pi = 0.A2F9836E 4E441529 ...
+// 1280 bits cover the Payne-Hanek reduction of any finite double with 192 bits to spare
+alignas(64) inline constexpr unsigned int two_over_pi[] = {
+    0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0, 0xDB629599, 0x3C439041, 0xFE5163AB, 0xDEBBC561,
+    0xB7246E3A, 0x424DD2E0, 0x06492EEA, 0x09D1921C, 0xFE1DEB1C, 0xB129A73E, 0xE88235F5, 0x2EBB4484,
+    0xE99C7026, 0xB45F7E41, 0x3991D639, 0x835339F4, 0x9C845F8B, 0xBDF9283B, 0x1FF897FF, 0xDE05980F,
+    0xEF2F118B, 0x5A0A6D1F, 0x6D367ECF, 0x27CB09B7, 0x4F463F66, 0x9E5FEA2D, 0x7527BAC7, 0xEBE5F17B,
+    0x3D0739F7, 0x8A5292EA, 0x6BFB5FB1, 0x1F8D5D08, 0x56033046, 0xFC7B6BAB, 0xF0CFBC20, 0x9AF4361D};
+
+// pi/2 split for Cody-Waite reduction: pio2_1 and pio2_2 hold 33 significant bits so that
+// k * pio2_1 and k * pio2_2 are exact for k < 2^20, pio2_3 is the rest rounded to double
+constexpr double pio2_1 = 0x1.921fb544p+0;
+constexpr double pio2_2 = 0x1.0b4611a6p-34;
+constexpr double pio2_3 = 0x1.3198a2e037073p-69;
+
+// pi/2 as a double-double: pio2_hi + pio2_lo
+constexpr double pio2_hi = 0x1.921fb54442d18p+0;
+constexpr double pio2_lo = 0x1.1a62633145c07p-54;
+
+namespace ct
+{
+/// <summary>
+/// Compile-time square root of x > 0 by Newton iteration, used only to generate the tables below
+/// </summary>
+constexpr double sqrt(double x)
+{
+    long double r = x > 1 ? x : 1;
+    for (int i = 0; i < 100; i++)
+        r = (r + x / r) / 2;
+    return double(r);
+}
+
+/// <summary>
+/// Initial guesses of sqrt(f) for f in [0.25, 1), one per 1/64 wide interval
+/// Each entry is the square root of the interval midpoint, good to about 7 bits
+/// </summary>
+struct SqrtSeed
+{
+    double v[48];
+    constexpr SqrtSeed() : v()
+    {
+        for (int i = 0; i < 48; i++)
+            v[i] = sqrt((16 + i + 0.5) / 64);
+    }
+    constexpr double operator[](int i) const { return v[i]; }
+};
+} // namespace ct
+
+alignas(64) inline constexpr ct::SqrtSeed sqrt_seed{};
+
+namespace ct
+{
+/// <summary>
+/// Inverse gains of the pseudo-rotation steps less one, 1/sqrt(1 + t^2) - 1 where t is 10^-i rounded to double
+/// A step by t grows the vector by sqrt(1 + t^2); held as the difference from 1, a product of them keeps the
+/// bits a product of the gains themselves would round away. Newton iteration in long double, rounded once
+/// </summary>
+template <int N>
+struct GainDelta
+{
+    double v[N];
+    constexpr GainDelta() : v()
+    {
+        for (int i = 0; i < N; i++)
+        {
+            const long double t = 1 / pow10(i);
+            const long double a = 1 + t * t;
+            long double r = 1; // a is in [1, 2], where Newton converges from 1
+            for (int k = 0; k < 100; k++)
+                r = r * (3 - a * r * r) / 2;
+            v[i] = double(r - 1);
+        }
+    }
+    constexpr double operator[](int i) const { return v[i]; }
+};
+} // namespace ct
+
+alignas(64) inline constexpr ct::GainDelta<24> gain_delta{};